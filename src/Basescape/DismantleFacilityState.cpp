@@ -125,7 +125,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 			_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() + _fac->getRules()->getBuildCost());
 			for (std::map<std::string, std::pair<int, int> >::const_iterator i = itemCost.begin(); i != itemCost.end(); ++i)
 			{
-				_base->getStorageItems()->addItem(i->first, i->second.first);
+				_base->getStorageItems()->addItem(_game->getMod()->getItem(i->first, true), i->second.first);
 			}
 		}
 		else
@@ -134,7 +134,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 			_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() + _fac->getRules()->getRefundValue());
 			for (std::map<std::string, std::pair<int, int> >::const_iterator i = itemCost.begin(); i != itemCost.end(); ++i)
 			{
-				_base->getStorageItems()->addItem(i->first, i->second.second);
+				_base->getStorageItems()->addItem(_game->getMod()->getItem(i->first, true), i->second.second);
 			}
 		}
 
@@ -143,6 +143,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 			if (*i == _fac)
 			{
 				_base->getFacilities()->erase(i);
+				_base->invalidateCapacities();
 				// Determine if we leave behind any facilities when this one is removed
 				if (_fac->getBuildTime() == 0 && _fac->getRules()->getLeavesBehindOnSell().size() != 0)
 				{
@@ -166,6 +167,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 							fac->setIfHadPreviousFacility(true);
 						}
 						_base->getFacilities()->push_back(fac);
+						_base->invalidateCapacities();
 					}
 					else
 					{
@@ -191,6 +193,7 @@ void DismantleFacilityState::btnOkClick(Action *)
 									fac->setIfHadPreviousFacility(true);
 								}
 								_base->getFacilities()->push_back(fac);
+								_base->invalidateCapacities();
 
 								++j;
 								if (j == facList.size())
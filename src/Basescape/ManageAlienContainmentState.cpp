@@ -216,8 +216,8 @@ void ManageAlienContainmentState::resetListAndTotals()
 	const std::vector<std::string> &items = _game->getMod()->getItemsList();
 	for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 	{
-		int qty = _base->getStorageItems()->getItem(*i);
 		RuleItem *rule = _game->getMod()->getItem(*i, true);
+		int qty = _base->getStorageItems()->getItem(rule);
 		if (qty > 0 && rule->isAlien() && rule->getPrisonType() == _prisonType)
 		{
 			_qtys.push_back(0);
@@ -325,7 +325,7 @@ void ManageAlienContainmentState::dealWithSelectedAliens(bool sell)
 		if (_qtys[i] > 0)
 		{
 			// remove the aliens
-			_base->getStorageItems()->removeItem(_aliens[i], _qtys[i]);
+			_base->getStorageItems()->removeItem(_game->getMod()->getItem(_aliens[i], true), _qtys[i]);
 
 			if (sell)
 			{
@@ -340,7 +340,7 @@ void ManageAlienContainmentState::dealWithSelectedAliens(bool sell)
 					auto ruleCorpse = ruleUnit->getArmor()->getCorpseGeoscape();
 					if (ruleCorpse && ruleCorpse->isRecoverable() && ruleCorpse->isCorpseRecoverable())
 					{
-						_base->getStorageItems()->addItem(ruleCorpse->getType(), _qtys[i]);
+						_base->getStorageItems()->addItem(ruleCorpse, _qtys[i]);
 					}
 				}
 			}
@@ -501,7 +501,7 @@ void ManageAlienContainmentState::lstItemsMousePress(Action *action)
  */
 int ManageAlienContainmentState::getQuantity()
 {
-	return _base->getStorageItems()->getItem(_aliens[_sel]);
+	return _base->getStorageItems()->getItem(_game->getMod()->getItem(_aliens[_sel], true));
 }
 
 /**
@@ -234,7 +234,7 @@ void PlaceFacilityState::viewClick(Action *)
 		{
 			for (const auto& i: _rule->getBuildCostItems())
 			{
-				int needed = i.second.first - _base->getStorageItems()->getItem(i.first);
+				int needed = i.second.first - _base->getStorageItems()->getItem(_game->getMod()->getItem(i.first, true));
 				if (needed > 0)
 				{
 					_game->popState();
@@ -260,7 +260,7 @@ void PlaceFacilityState::viewClick(Action *)
 						_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() + checkFacility->getRules()->getBuildCost());
 						for (std::map<std::string, std::pair<int, int> >::const_iterator j = itemCost.begin(); j != itemCost.end(); ++j)
 						{
-							_base->getStorageItems()->addItem(j->first, j->second.first);
+							_base->getStorageItems()->addItem(_game->getMod()->getItem(j->first, true), j->second.first);
 						}
 					}
 					else
@@ -269,7 +269,7 @@ void PlaceFacilityState::viewClick(Action *)
 						_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() + checkFacility->getRules()->getRefundValue());
 						for (std::map<std::string, std::pair<int, int> >::const_iterator j = itemCost.begin(); j != itemCost.end(); ++j)
 						{
-							_base->getStorageItems()->addItem(j->first, j->second.second);
+							_base->getStorageItems()->addItem(_game->getMod()->getItem(j->first, true), j->second.second);
 						}
 
 						// Reduce the build time of the new facility
@@ -284,6 +284,7 @@ void PlaceFacilityState::viewClick(Action *)
 
 					// Remove the facility from the base
 					_base->getFacilities()->erase(_base->getFacilities()->begin() + i);
+					_base->invalidateCapacities();
 					delete checkFacility;
 				}
 
@@ -301,6 +302,7 @@ void PlaceFacilityState::viewClick(Action *)
 				fac->setBuildTime(std::max(1, fac->getBuildTime() - reducedBuildTimeRounded));
 			}
 			_base->getFacilities()->push_back(fac);
+			_base->invalidateCapacities();
 			if (Options::allowBuildingQueue)
 			{
 				if (_view->isQueuedBuilding(_rule)) fac->setBuildTime(INT_MAX);
@@ -310,7 +312,7 @@ void PlaceFacilityState::viewClick(Action *)
 			_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() - _rule->getBuildCost());
 			for (const auto& i: _rule->getBuildCostItems())
 			{
-				_base->getStorageItems()->removeItem(i.first, i.second.first);
+				_base->getStorageItems()->removeItem(_game->getMod()->getItem(i.first, true), i.second.first);
 			}
 			_game->popState();
 		}
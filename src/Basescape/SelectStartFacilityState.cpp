@@ -82,6 +82,7 @@ void SelectStartFacilityState::btnOkClick(Action *)
 		delete *i;
 	}
 	_base->getFacilities()->clear();
+	_base->invalidateCapacities();
 	_game->popState();
 	_game->popState();
 	_game->pushState(new PlaceLiftState(_base, _globe, true));
@@ -243,7 +243,7 @@ void SellState::delayedInit()
 			{
 				for (std::vector<Transfer*>::iterator j = _base->getTransfers()->begin(); j != _base->getTransfers()->end(); ++j)
 				{
-					if ((*j)->getItems() == *i)
+					if ((*j)->getItems() == rule)
 					{
 						qty += (*j)->getQuantity();
 					}
@@ -658,7 +658,7 @@ void SellState::btnOkClick(Action *)
 					{
 						if ((*s)->getArmor()->getStoreItem())
 						{
-							_base->getStorageItems()->addItem((*s)->getArmor()->getStoreItem()->getType());
+							_base->getStorageItems()->addItem((*s)->getArmor()->getStoreItem());
 						}
 						_base->getSoldiers()->erase(s);
 						break;
@@ -696,7 +696,7 @@ void SellState::btnOkClick(Action *)
 					// if there are STILL any left to remove, take them from the transfers, and if necessary, delete it.
 					for (std::vector<Transfer*>::iterator j = _base->getTransfers()->begin(); j != _base->getTransfers()->end() && toRemove;)
 					{
-						if ((*j)->getItems() == item->getType())
+						if ((*j)->getItems() == item)
 						{
 							if ((*j)->getQuantity() <= toRemove)
 							{
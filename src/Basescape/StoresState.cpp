@@ -282,7 +282,7 @@ void StoresState::initList(bool grandTotal)
 		if (!grandTotal)
 		{
 			// items in stores from this base only
-			qty += _base->getStorageItems()->getItem(*item);
+			qty += _base->getStorageItems()->getItem(rule);
 		}
 		else
 		{
@@ -330,7 +330,7 @@ void StoresState::initList(bool grandTotal)
 						// 5a. craft equipment, weapons, vehicles
 						qty += craft2->getTotalItemCount(rule);
 					}
-					else if ((*transfer)->getItems() == (*item))
+					else if ((*transfer)->getItems() == rule)
 					{
 						// 5b. items in transfer
 						qty += (*transfer)->getQuantity();
@@ -31,6 +31,9 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/Options.h"
+#include "../Engine/ThreadPool.h"
+#include "../Engine/Profiler.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
@@ -39,6 +42,13 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Tiles of an AI tile search checked by each thread at a time. Small chunks waste little work past an early exit.
+const size_t SEARCH_TILES_PER_THREAD = 4;
+
+}
 
 /**
  * Sets up a BattleAIState.
@@ -79,6 +89,15 @@ AIModule::~AIModule()
 	delete _psiAction;
 }
 
+/**
+ * Changes the faction the unit is hunting.
+ * @param faction Faction of the targets.
+ */
+void AIModule::setTargetFaction(UnitFaction faction)
+{
+	_targetFaction = faction;
+}
+
 /**
  * Resets the unsaved AI state.
  */
@@ -89,6 +108,67 @@ void AIModule::reset()
 	_ambushTUs = 0;
 }
 
+/**
+ * Gets the TU costs of the cheapest paths from the unit's current position,
+ * calculating them on first use in a think().
+ * @return Cost field of the unit.
+ */
+const PathfindingCostField &AIModule::getCostField()
+{
+	if (!_costField.isValidFor(_unit, _unit->getPosition()))
+	{
+		_save->getPathfinding()->calculateCostField(_costField, _unit);
+	}
+	return _costField;
+}
+
+/**
+ * Gets the TU costs of the cheapest paths from the unit's current position,
+ * with no practical limit on the cost, calculating them on first use in a think().
+ * @return Cost field of the unit.
+ */
+const PathfindingCostField &AIModule::getChargeCostField()
+{
+	const int maxTUCost = 100000; // disregard unit's TUs.
+	if (!_chargeCostField.isValidFor(_unit, _unit->getPosition(), maxTUCost))
+	{
+		_save->getPathfinding()->calculateCostField(_chargeCostField, _unit, maxTUCost);
+	}
+	return _chargeCostField;
+}
+
+/**
+ * Marks the tiles of a list of tile indices in a lookup table,
+ * so checking if a tile is in the list takes constant time.
+ * @param indices Tile indices, eg. the reachable tiles from Pathfinding.
+ * @return Lookup table with an entry for every tile of the map.
+ */
+std::vector<bool> AIModule::getReachableLookup(const std::vector<int> &indices) const
+{
+	std::vector<bool> lookup(_save->getMapSizeXYZ(), false);
+	for (std::vector<int>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+	{
+		lookup[*i] = true;
+	}
+	return lookup;
+}
+
+/**
+ * Checks if a position is marked in a lookup table of the map.
+ * @param lookup Lookup table from getReachableLookup, can be empty.
+ * @param pos Position to check.
+ * @return True if the position is in the map and marked.
+ */
+bool AIModule::isReachable(const std::vector<bool> &lookup, Position pos) const
+{
+	if (_save->getTile(pos) == 0)
+	{
+		return false;
+	}
+	size_t index = _save->getTileIndex(pos);
+	return index < lookup.size() && lookup[index];
+}
+
 /**
  * Loads the AI state from a YAML file.
  * @param node YAML node.
@@ -200,6 +280,8 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	Profiler::Scope profile(PROF_AI_THINK);
+
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -214,7 +296,9 @@ void AIModule::think(BattleAction *action)
 	_melee = (_unit->getUtilityWeapon(BT_MELEE) != 0);
 	_rifle = false;
 	_blaster = false;
-	_reachable = _save->getPathfinding()->findReachable(_unit, BattleActionCost());
+	_reachable = getReachableLookup(_save->getPathfinding()->findReachable(_unit, BattleActionCost()));
+	_costField.clear();
+	_chargeCostField.clear();
 	_wasHitBy.clear();
 	_foundBaseModuleToDestroy = false;
 
@@ -269,18 +353,18 @@ void AIModule::think(BattleAction *action)
 				if (action->weapon->getCurrentWaypoints() != 0)
 				{
 					_blaster = true;
-					_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_AIMEDSHOT, _unit, action->weapon));
+					_reachableWithAttack = getReachableLookup(_save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_AIMEDSHOT, _unit, action->weapon)));
 				}
 				else
 				{
 					_rifle = true;
-					_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_SNAPSHOT, _unit, action->weapon));
+					_reachableWithAttack = getReachableLookup(_save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_SNAPSHOT, _unit, action->weapon)));
 				}
 			}
 			else if (rule->getBattleType() == BT_MELEE)
 			{
 				_melee = true;
-				_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, action->weapon));
+				_reachableWithAttack = getReachableLookup(_save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, action->weapon)));
 			}
 		}
 		else
@@ -687,6 +771,8 @@ void AIModule::setupAmbush()
 		const int COVER_BONUS = 25;
 		const int FAST_PASS_THRESHOLD = 80;
 		Position origin = _save->getTileEngine()->getSightOriginVoxel(_aggroTarget);
+		const PathfindingCostField &costField = getCostField();
+		PathfindingCostField targetCostField;
 
 		// we'll use node positions for this, as it gives map makers a good degree of control over how the units will use the environment.
 		for (std::vector<Node*>::const_iterator i = _save->getNodes()->begin(); i != _save->getNodes()->end(); ++i)
@@ -698,7 +784,7 @@ void AIModule::setupAmbush()
 			Position pos = (*i)->getPosition();
 			Tile *tile = _save->getTile(pos);
 			if (tile == 0 || Position::distance2d(pos, _unit->getPosition()) > 10 || pos.z != _unit->getPosition().z || tile->getDangerous() ||
-				std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
+				!isReachable(_reachableWithAttack, pos))
 				continue; // just ignore unreachable tiles
 
 			if (_traceAI)
@@ -712,18 +798,20 @@ void AIModule::setupAmbush()
 			Position target;
 			if (!_save->getTileEngine()->canTargetUnit(&origin, tile, &target, _aggroTarget, false, _unit) && !getSpottingUnits(pos))
 			{
-				_save->getPathfinding()->calculate(_unit, pos);
-				int ambushTUs = _save->getPathfinding()->getTotalTUCost();
+				int ambushTUs = costField.getTUCost(pos);
 				// make sure we can move here
-				if (_save->getPathfinding()->getStartDirection() != -1)
+				if (costField.getPathLength(pos) > 0)
 				{
 					int score = BASE_SYSTEMATIC_SUCCESS;
 					score -= ambushTUs;
 
 					// make sure our enemy can reach here too.
-					_save->getPathfinding()->calculate(_aggroTarget, pos);
+					if (!targetCostField.isValidFor(_aggroTarget, _aggroTarget->getPosition()))
+					{
+						_save->getPathfinding()->calculateCostField(targetCostField, _aggroTarget);
+					}
 
-					if (_save->getPathfinding()->getStartDirection() != -1)
+					if (targetCostField.getPathLength(pos) > 0)
 					{
 						// ideally we'd like to be behind some cover, like say a window or a low wall.
 						if (_save->getTileEngine()->faceWindow(pos) != -1)
@@ -732,7 +820,7 @@ void AIModule::setupAmbush()
 						}
 						if (score > bestScore)
 						{
-							path = _save->getPathfinding()->copyPath();
+							path = targetCostField.getPath(pos);
 							bestScore = score;
 							_ambushTUs = (pos == _unit->getPosition()) ? 1 : ambushTUs;
 							_ambushAction->target = pos;
@@ -911,8 +999,17 @@ void AIModule::setupEscape()
 	std::vector<Position> randomTileSearch = _save->getTileSearch();
 	RNG::shuffle(randomTileSearch);
 
+	// spotters of the systematic search tiles, counted a chunk at a time on the thread pool
+	const int SYSTEMATIC_TRIES = 121;
+	const int chunkSize = ThreadPool::getShared().getThreadCount() * SEARCH_TILES_PER_THREAD;
+	std::vector<int> searchSpotters(SYSTEMATIC_TRIES, 0);
+	int searchCounted = 0;
+	std::vector<Position> countPositions;
+	std::vector<int> countTries, counts;
+
 	while (tries < 150 && !coverFound)
 	{
+		int searchTry = -1;
 		_escapeAction->target = _unit->getPosition(); // start looking in a direction away from the enemy
 
 		if (!_save->getTile(_escapeAction->target))
@@ -931,12 +1028,13 @@ void AIModule::setupEscape()
 				_escapeAction->target = _unit->lastCover;
 			}
 		}
-		else if (tries < 121)
+		else if (tries < SYSTEMATIC_TRIES)
 		{
 			// looking for cover
 			_escapeAction->target.x += randomTileSearch[tries].x;
 			_escapeAction->target.y += randomTileSearch[tries].y;
 			score = BASE_SYSTEMATIC_SUCCESS;
+			searchTry = tries;
 			if (_escapeAction->target == _unit->getPosition())
 			{
 				if (unitsSpottingMe > 0)
@@ -944,6 +1042,7 @@ void AIModule::setupEscape()
 					// maybe don't stay in the same spot? move or something if there's any point to it?
 					_escapeAction->target.x += RNG::generate(-20,20);
 					_escapeAction->target.y += RNG::generate(-20,20);
+					searchTry = -1;
 				}
 				else
 				{
@@ -953,7 +1052,7 @@ void AIModule::setupEscape()
 		}
 		else
 		{
-			if (tries == 121)
+			if (tries == SYSTEMATIC_TRIES)
 			{
 				if (_traceAI)
 				{
@@ -996,8 +1095,38 @@ void AIModule::setupEscape()
 		}
 		else
 		{
-			spotters = getSpottingUnits(_escapeAction->target);
-			if (std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(_escapeAction->target))  == _reachable.end())
+			if (searchTry >= 0)
+			{
+				if (searchTry >= searchCounted)
+				{
+					// the tiles depend only on the shuffled search, not on the RNG calls in between
+					countPositions.clear();
+					countTries.clear();
+					searchCounted = std::min(searchTry + chunkSize, SYSTEMATIC_TRIES);
+					for (int t = searchTry; t < searchCounted; ++t)
+					{
+						Position pos = _unit->getPosition();
+						pos.x += randomTileSearch[t].x;
+						pos.y += randomTileSearch[t].y;
+						if (isReachable(_reachable, pos) && (pos != _unit->getPosition() || unitsSpottingMe == 0))
+						{
+							countPositions.push_back(pos);
+							countTries.push_back(t);
+						}
+					}
+					getSpottingUnits(countPositions, counts);
+					for (size_t c = 0; c < countTries.size(); ++c)
+					{
+						searchSpotters[countTries[c]] = counts[c];
+					}
+				}
+				spotters = searchSpotters[searchTry];
+			}
+			else
+			{
+				spotters = getSpottingUnits(_escapeAction->target);
+			}
+			if (!isReachable(_reachable, _escapeAction->target))
 				continue; // just ignore unreachable tiles
 
 			if (_spottingEnemies || spotters)
@@ -1031,13 +1160,13 @@ void AIModule::setupEscape()
 
 		if (tile && score > bestTileScore)
 		{
-			// calculate TUs to tile; we could be getting this from findReachable() somehow but that would break something for sure...
-			_save->getPathfinding()->calculate(_unit, _escapeAction->target);
-			if (_escapeAction->target == _unit->getPosition() || _save->getPathfinding()->getStartDirection() != -1)
+			// TUs to tile, from the costs of all paths calculated once per think()
+			const PathfindingCostField &costField = getCostField();
+			if (_escapeAction->target == _unit->getPosition() || costField.getPathLength(_escapeAction->target) > 0)
 			{
 				bestTileScore = score;
 				bestTile = _escapeAction->target;
-				_escapeTUs = _save->getPathfinding()->getTotalTUCost();
+				_escapeTUs = costField.getTUCost(_escapeAction->target);
 				if (_escapeAction->target == _unit->getPosition())
 				{
 					_escapeTUs = 1;
@@ -1049,7 +1178,6 @@ void AIModule::setupEscape()
 					tile->setTUMarker(score);
 				}
 			}
-			_save->getPathfinding()->abortPath();
 			if (bestTileScore > FAST_PASS_THRESHOLD) coverFound = true; // good enough, gogogo
 		}
 	}
@@ -1078,6 +1206,149 @@ void AIModule::setupEscape()
 	}
 }
 
+/**
+ * Checks if a possible spotter is in the same state as when traced.
+ * @param other State to compare with.
+ * @return True if the traces are still valid.
+ */
+bool AIExposureMap::SpotterState::operator==(const SpotterState &other) const
+{
+	return unit == other.unit && position == other.position && height == other.height && faction == other.faction && out == other.out;
+}
+
+/**
+ * Creates an exposure map without any traced tiles.
+ * @param save Pointer to the battle.
+ */
+AIExposureMap::AIExposureMap(SavedBattleGame *save) : _save(save), _generation(1)
+{
+}
+
+/**
+ * Compares the units with their state from the last check,
+ * and drops all the entries if anything that the traces
+ * depend on has changed, eg. a player unit moved or died.
+ * Units of the side taking its turn are never spotters, but
+ * they still block lines of fire, so their moves count too.
+ */
+void AIExposureMap::checkSpotters()
+{
+	std::vector<BattleUnit*> *units = _save->getUnits();
+	bool changed = units->size() != _spotterStates.size();
+	_spotterStates.resize(units->size());
+	for (size_t i = 0; i < units->size(); ++i)
+	{
+		BattleUnit *unit = (*units)[i];
+		// units of the acting side count too, their bodies block the lines of fire
+		SpotterState state = { unit, unit->getPosition(), unit->getHeight(), unit->getFaction(), unit->isOut() };
+		if (!(_spotterStates[i] == state))
+		{
+			_spotterStates[i] = state;
+			changed = true;
+		}
+	}
+	if (changed)
+	{
+		invalidate();
+	}
+}
+
+/**
+ * Gets the units of the target faction in range that could target
+ * a unit shaped like the given one, if it stood on a tile.
+ * The tile is traced the first time it is asked for.
+ * @param unit Unit to place on the tile.
+ * @param targetFaction Faction of the spotters.
+ * @param pos Position of the tile.
+ * @return The spotters, to be filtered by what the unit knows about them.
+ */
+const std::vector<BattleUnit*> &AIExposureMap::getSpotters(BattleUnit *unit, UnitFaction targetFaction, Position pos)
+{
+	checkSpotters();
+
+	Entry &entry = getEntries(unit, targetFaction)[_save->getTileIndex(pos)];
+	if (entry.generation != _generation)
+	{
+		traceEntry(entry, unit, targetFaction, pos);
+	}
+	return entry.spotters;
+}
+
+/**
+ * Traces the tiles that are not in the map yet, splitting them
+ * between the threads of the pool. The traces only read the battle.
+ * @param unit Unit to place on the tiles.
+ * @param targetFaction Faction of the spotters.
+ * @param positions Positions of the tiles.
+ */
+void AIExposureMap::traceAll(BattleUnit *unit, UnitFaction targetFaction, const std::vector<Position> &positions)
+{
+	checkSpotters();
+
+	std::vector<Entry> &entries = getEntries(unit, targetFaction);
+	std::vector<Position> missing;
+	for (std::vector<Position>::const_iterator i = positions.begin(); i != positions.end(); ++i)
+	{
+		Entry &entry = entries[_save->getTileIndex(*i)];
+		if (entry.generation != _generation)
+		{
+			entry.generation = _generation; // don't trace the same tile twice
+			missing.push_back(*i);
+		}
+	}
+	ThreadPool::getShared().run(missing.size(),
+		[&](size_t i, int thread)
+		{
+			traceEntry(entries[_save->getTileIndex(missing[i])], unit, targetFaction, missing[i]);
+		}
+	);
+}
+
+/**
+ * Gets the entries for a target faction and the shape of a unit,
+ * creating them for the whole map on first use.
+ * @param unit Unit to place on the tiles.
+ * @param targetFaction Faction of the spotters.
+ * @return Entries for every tile of the map.
+ */
+std::vector<AIExposureMap::Entry> &AIExposureMap::getEntries(BattleUnit *unit, UnitFaction targetFaction)
+{
+	std::vector<Entry> &entries = _entries[std::make_tuple((int)targetFaction, unit->getHeight(), unit->getFloatHeight(), unit->getLoftemps())];
+	if (entries.empty())
+	{
+		entries.resize(_save->getMapSizeXYZ());
+	}
+	return entries;
+}
+
+/**
+ * Traces lines of fire from the spotters in range to a tile.
+ * @param entry Entry of the tile to fill.
+ * @param unit Unit to place on the tile.
+ * @param targetFaction Faction of the spotters.
+ * @param pos Position of the tile.
+ */
+void AIExposureMap::traceEntry(Entry &entry, BattleUnit *unit, UnitFaction targetFaction, Position pos)
+{
+	entry.generation = _generation;
+	entry.spotters.clear();
+	Tile *tile = _save->getTile(pos);
+	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->isOut() || (*i)->getFaction() != targetFaction || Position::distance2d(pos, (*i)->getPosition()) > 20)
+		{
+			continue;
+		}
+		Position originVoxel = _save->getTileEngine()->getSightOriginVoxel(*i);
+		originVoxel.z -= 2;
+		Position targetVoxel;
+		if (_save->getTileEngine()->canTargetUnit(&originVoxel, tile, &targetVoxel, *i, false, unit))
+		{
+			entry.spotters.push_back(*i);
+		}
+	}
+}
+
 /**
  * Counts how many targets, both xcom and civilian are known to this unit
  * @return how many targets are known to us.
@@ -1109,6 +1380,18 @@ int AIModule::getSpottingUnits(const Position& pos) const
 	// if we don't actually occupy the position being checked, we need to do a virtual LOF check.
 	bool checking = pos != _unit->getPosition();
 	int tally = 0;
+	if (checking && useExposureMap())
+	{
+		// virtual checks place the unit on the tile, so only its shape matters and they can be shared
+		for (BattleUnit *spotter : _save->getExposureMap()->getSpotters(_unit, _targetFaction, pos))
+		{
+			if (validTarget(spotter, false, false))
+			{
+				tally++;
+			}
+		}
+		return tally;
+	}
 	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
 		if (validTarget(*i, false, false))
@@ -1137,6 +1420,53 @@ int AIModule::getSpottingUnits(const Position& pos) const
 	return tally;
 }
 
+/**
+ * Counts the enemies that could target the unit on each of the positions,
+ * the same as getSpottingUnits for one position. The traces run on the
+ * thread pool and only read the battle.
+ * @param positions Positions to check.
+ * @param counts Returns the number of spotting units for each position.
+ */
+void AIModule::getSpottingUnits(const std::vector<Position> &positions, std::vector<int> &counts) const
+{
+	counts.assign(positions.size(), 0);
+	if (useExposureMap())
+	{
+		std::vector<Position> virtualPositions;
+		for (std::vector<Position>::const_iterator i = positions.begin(); i != positions.end(); ++i)
+		{
+			if (*i != _unit->getPosition())
+			{
+				virtualPositions.push_back(*i);
+			}
+		}
+		_save->getExposureMap()->traceAll(_unit, _targetFaction, virtualPositions);
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			counts[i] = getSpottingUnits(positions[i]);
+		}
+	}
+	else
+	{
+		ThreadPool::getShared().run(positions.size(),
+			[&](size_t i, int thread)
+			{
+				counts[i] = getSpottingUnits(positions[i]);
+			}
+		);
+	}
+}
+
+/**
+ * Checks if the virtual line of fire checks of this unit can be shared
+ * with other units through the exposure map of the battle.
+ * @return True if the exposure map is used.
+ */
+bool AIModule::useExposureMap() const
+{
+	return Options::oxceAIExposureMap && _unit->getArmor()->getSize() == 1;
+}
+
 /**
  * Selects the nearest known living target we can see/reach and returns the number of visible enemies.
  * This function includes civilians as viable targets.
@@ -1287,8 +1617,9 @@ bool AIModule::selectRandomTarget()
  * @param maxTUs Maximum time units the path to the target can cost.
  * @return True if a point was found.
  */
-bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
+bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs)
 {
+	const PathfindingCostField &costField = getCostField();
 	int size = _unit->getArmor()->getSize();
 	int sizeTarget = target->getArmor()->getSize();
 	int dirTarget = target->getDirection();
@@ -1304,7 +1635,7 @@ bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position (x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath))  == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || !isReachable(_reachable, checkPath))
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1312,17 +1643,16 @@ bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
 
 					if (valid && fitHere && !_save->getTile(checkPath)->getDangerous())
 					{
-						_save->getPathfinding()->calculate(_unit, checkPath, 0, maxTUs);
+						int pathLength = costField.getPathLength(checkPath);
 
 						//for 100% dodge diff and on 4th difficulty it will allow aliens to move 10 squares around to made attack from behind.
-						int distanceCurrent = _save->getPathfinding()->getPath().size() - dodgeChanceDiff * _save->getTileEngine()->getArcDirection(dir - 4, dirTarget);
-						if (_save->getPathfinding()->getStartDirection() != -1 && distanceCurrent < distance)
+						int distanceCurrent = pathLength - dodgeChanceDiff * _save->getTileEngine()->getArcDirection(dir - 4, dirTarget);
+						if (pathLength > 0 && costField.getTUCost(checkPath) <= maxTUs && distanceCurrent < distance)
 						{
 							_attackAction->target = checkPath;
 							returnValue = true;
 							distance = distanceCurrent;
 						}
-						_save->getPathfinding()->abortPath();
 					}
 				}
 			}
@@ -1340,8 +1670,9 @@ bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
  * @param target Pointer to a target.
  * @return True if a point was found.
  */
-bool AIModule::selectPointNearTargetLeeroy(BattleUnit *target) const
+bool AIModule::selectPointNearTargetLeeroy(BattleUnit *target)
 {
+	const PathfindingCostField &costField = getChargeCostField();
 	int size = _unit->getArmor()->getSize();
 	int targetsize = target->getArmor()->getSize();
 	bool returnValue = false;
@@ -1355,7 +1686,7 @@ bool AIModule::selectPointNearTargetLeeroy(BattleUnit *target) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position(x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath)) == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || !isReachable(_reachable, checkPath))
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1363,14 +1694,13 @@ bool AIModule::selectPointNearTargetLeeroy(BattleUnit *target) const
 
 					if (valid && fitHere)
 					{
-						_save->getPathfinding()->calculate(_unit, checkPath, 0, 100000); // disregard unit's TUs.
-						if (_save->getPathfinding()->getStartDirection() != -1 && _save->getPathfinding()->getPath().size() < distance)
+						int pathLength = costField.getPathLength(checkPath);
+						if (pathLength > 0 && (unsigned int)pathLength < distance)
 						{
 							_attackAction->target = checkPath;
 							returnValue = true;
-							distance = _save->getPathfinding()->getPath().size();
+							distance = pathLength;
 						}
-						_save->getPathfinding()->abortPath();
 					}
 				}
 			}
@@ -1814,60 +2144,89 @@ bool AIModule::findFirePoint()
 		return false;
 	std::vector<Position> randomTileSearch = _save->getTileSearch();
 	RNG::shuffle(randomTileSearch);
-	Position target;
 	const int BASE_SYSTEMATIC_SUCCESS = 100;
 	const int FAST_PASS_THRESHOLD = 125;
 	bool waitIfOutsideWeaponRange = _unit->getGeoscapeSoldier() ? false : _unit->getUnitRules()->waitIfOutsideWeaponRange();
 	bool extendedFireModeChoiceEnabled = _save->getBattleGame()->getMod()->getAIExtendedFireModeChoice();
 	int bestScore = 0;
 	_attackAction->type = BA_RETHINK;
-	for (std::vector<Position>::const_iterator i = randomTileSearch.begin(); i != randomTileSearch.end(); ++i)
+
+	// the tiles are checked a chunk at a time on the thread pool, then scored in search order,
+	// so the chosen tile is the same as when checking them one after another
+	ThreadPool &pool = ThreadPool::getShared();
+	const size_t chunkSize = pool.getThreadCount() * SEARCH_TILES_PER_THREAD;
+	const PathfindingCostField &costField = getCostField();
+	std::vector<Position> candidates;
+	std::vector<char> canTarget;
+	std::vector<int> spotters;
+	bool fastPass = false;
+	for (size_t first = 0; first < randomTileSearch.size() && !fastPass; first += chunkSize)
 	{
-		Position pos = _unit->getPosition() + *i;
-		Tile *tile = _save->getTile(pos);
-		if (tile == 0  ||
-			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
-			continue;
-		int score = 0;
-		// i should really make a function for this
-		Position origin = pos.toVoxel() +
-			// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
-			Position(8,8, _unit->getHeight() + _unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+		// can move here
+		candidates.clear();
+		for (size_t i = first; i < std::min(first + chunkSize, randomTileSearch.size()); ++i)
+		{
+			Position pos = _unit->getPosition() + randomTileSearch[i];
+			if (isReachable(_reachableWithAttack, pos) && costField.getPathLength(pos) > 0)
+			{
+				candidates.push_back(pos);
+			}
+		}
 
-		if (_save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit, false))
+		canTarget.assign(candidates.size(), 0);
+		pool.run(candidates.size(),
+			[&](size_t i, int thread)
+			{
+				// i should really make a function for this
+				Position origin = candidates[i].toVoxel() +
+					// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
+					Position(8,8, _unit->getHeight() + _unit->getFloatHeight() - _save->getTile(candidates[i])->getTerrainLevel() - 4);
+				Position target;
+				canTarget[i] = _save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit, false);
+			}
+		);
+		size_t targetable = 0;
+		for (size_t i = 0; i < candidates.size(); ++i)
 		{
-			_save->getPathfinding()->calculate(_unit, pos);
-			// can move here
-			if (_save->getPathfinding()->getStartDirection() != -1)
+			if (canTarget[i])
 			{
-				score = BASE_SYSTEMATIC_SUCCESS - getSpottingUnits(pos) * 10;
-				score += _unit->getTimeUnits() - _save->getPathfinding()->getTotalTUCost();
-				if (!_aggroTarget->checkViewSector(pos))
-				{
-					score += 10;
-				}
+				candidates[targetable++] = candidates[i];
+			}
+		}
+		candidates.resize(targetable);
+		getSpottingUnits(candidates, spotters);
 
-				// Extended behavior: if we have a limited-range weapon, bump up the score for getting closer to the target, down for further
-				if (!waitIfOutsideWeaponRange && extendedFireModeChoiceEnabled)
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			Position pos = candidates[i];
+			int score = BASE_SYSTEMATIC_SUCCESS - spotters[i] * 10;
+			score += _unit->getTimeUnits() - costField.getTUCost(pos);
+			if (!_aggroTarget->checkViewSector(pos))
+			{
+				score += 10;
+			}
+
+			// Extended behavior: if we have a limited-range weapon, bump up the score for getting closer to the target, down for further
+			if (!waitIfOutsideWeaponRange && extendedFireModeChoiceEnabled)
+			{
+				int distanceToTarget = Position::distance2d(_unit->getPosition(), _aggroTarget->getPosition());
+				if (_attackAction->weapon && distanceToTarget > _attackAction->weapon->getRules()->getMaxRange()) // make sure we can get the ruleset before checking the range
 				{
-					int distanceToTarget = Position::distance2d(_unit->getPosition(), _aggroTarget->getPosition());
-					if (_attackAction->weapon && distanceToTarget > _attackAction->weapon->getRules()->getMaxRange()) // make sure we can get the ruleset before checking the range
-					{
-						int proposedDistance = Position::distance2d(pos, _aggroTarget->getPosition());
-						proposedDistance = std::max(proposedDistance, 1);
-						score = score * distanceToTarget / proposedDistance;
-					}
+					int proposedDistance = Position::distance2d(pos, _aggroTarget->getPosition());
+					proposedDistance = std::max(proposedDistance, 1);
+					score = score * distanceToTarget / proposedDistance;
 				}
+			}
 
-				if (score > bestScore)
+			if (score > bestScore)
+			{
+				bestScore = score;
+				_attackAction->target = pos;
+				_attackAction->finalFacing = _save->getTileEngine()->getDirectionTo(pos, _aggroTarget->getPosition());
+				if (score > FAST_PASS_THRESHOLD)
 				{
-					bestScore = score;
-					_attackAction->target = pos;
-					_attackAction->finalFacing = _save->getTileEngine()->getDirectionTo(pos, _aggroTarget->getPosition());
-					if (score > FAST_PASS_THRESHOLD)
-					{
-						break;
-					}
+					fastPass = true;
+					break;
 				}
 			}
 		}
@@ -2742,7 +3101,7 @@ void AIModule::selectMeleeOrRanged()
 		{
 			_rifle = false;
 			_attackAction->weapon = melee;
-			_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, melee));
+			_reachableWithAttack = getReachableLookup(_save->getPathfinding()->findReachable(_unit, BattleActionCost(BA_HIT, _unit, melee)));
 			return;
 		}
 	}
@@ -19,9 +19,12 @@
  */
 #include <yaml-cpp/yaml.h>
 #include "BattlescapeGame.h"
+#include "Pathfinding.h"
 #include "Position.h"
 #include "../Savegame/BattleUnit.h"
 #include <vector>
+#include <map>
+#include <tuple>
 
 
 namespace OpenXcom
@@ -34,6 +37,53 @@ class BattlescapeState;
 class Node;
 
 enum AIMode { AI_PATROL, AI_AMBUSH, AI_COMBAT, AI_ESCAPE };
+
+/**
+ * Enemies that could target a unit standing on each tile of the map, shared by all AI units.
+ * Tiles are traced when first asked for, and the traces are kept until the next turn,
+ * until any unit moves, changes side or goes down, or until the terrain changes.
+ */
+class AIExposureMap
+{
+private:
+	/// What the traces of a possible spotter depend on.
+	struct SpotterState
+	{
+		BattleUnit *unit;
+		Position position;
+		int height;
+		UnitFaction faction;
+		bool out;
+		bool operator==(const SpotterState &other) const;
+	};
+	/// The spotters of one tile.
+	struct Entry
+	{
+		Uint32 generation = 0;
+		std::vector<BattleUnit*> spotters;
+	};
+	SavedBattleGame *_save;
+	Uint32 _generation;
+	std::vector<SpotterState> _spotterStates;
+	/// Entries per target faction and shape of the hypothetical unit.
+	std::map<std::tuple<int, int, int, int>, std::vector<Entry> > _entries;
+	/// Drops all the entries if any spotter changed since they were traced.
+	void checkSpotters();
+	/// Gets the entries for a target faction and the shape of a unit.
+	std::vector<Entry> &getEntries(BattleUnit *unit, UnitFaction targetFaction);
+	/// Traces the spotters of one tile.
+	void traceEntry(Entry &entry, BattleUnit *unit, UnitFaction targetFaction, Position pos);
+public:
+	/// Creates an empty exposure map.
+	AIExposureMap(SavedBattleGame *save);
+	/// Drops all the entries.
+	void invalidate() { ++_generation; }
+	/// Gets the units of a faction that could target a unit if it stood on a tile.
+	const std::vector<BattleUnit*> &getSpotters(BattleUnit *unit, UnitFaction targetFaction, Position pos);
+	/// Traces all the tiles that are not in the map yet, on the thread pool.
+	void traceAll(BattleUnit *unit, UnitFaction targetFaction, const std::vector<Position> &positions);
+};
+
 /**
  * This class is used by the BattleUnit AI.
  */
@@ -52,11 +102,25 @@ private:
 	int _AIMode, _intelligence, _closestDist;
 	Node *_fromNode, *_toNode;
 	bool _foundBaseModuleToDestroy;
-	std::vector<int> _reachable, _reachableWithAttack, _wasHitBy;
+	std::vector<bool> _reachable, _reachableWithAttack;
+	std::vector<int> _wasHitBy;
 	BattleActionType _reserve;
 	UnitFaction _targetFaction;
+	PathfindingCostField _costField, _chargeCostField;
 
-	bool selectPointNearTargetLeeroy(BattleUnit *target) const;
+	/// Gets the TU costs of paths from the unit's current position.
+	const PathfindingCostField &getCostField();
+	/// Gets the TU costs of paths from the unit's current position, disregarding the unit's TUs.
+	const PathfindingCostField &getChargeCostField();
+	/// Converts a list of tile indices to a lookup table of the map.
+	std::vector<bool> getReachableLookup(const std::vector<int> &indices) const;
+	/// Checks if a position is marked in a lookup table of the map.
+	bool isReachable(const std::vector<bool> &lookup, Position pos) const;
+	/// Counts the enemies that could target the unit on each of the positions.
+	void getSpottingUnits(const std::vector<Position> &positions, std::vector<int> &counts) const;
+	/// Checks if virtual line of fire checks go through the exposure map.
+	bool useExposureMap() const;
+	bool selectPointNearTargetLeeroy(BattleUnit *target);
 	int selectNearestTargetLeeroy();
 	void meleeActionLeeroy();
 	void dont_think(BattleAction *action);
@@ -65,6 +129,8 @@ public:
 	AIModule(SavedBattleGame *save, BattleUnit *unit, Node *node);
 	/// Cleans up the AIModule.
 	~AIModule();
+	/// Sets the faction the unit is hunting.
+	void setTargetFaction(UnitFaction faction);
 	/// Resets the unsaved AI state.
 	void reset();
 	/// Loads the AI Module from YAML.
@@ -98,7 +164,7 @@ public:
 	/// Selects a random known target.
 	bool selectRandomTarget();
 	/// Selects the nearest reachable point relative to a target.
-	bool selectPointNearTarget(BattleUnit *target, int maxTUs) const;
+	bool selectPointNearTarget(BattleUnit *target, int maxTUs);
 	/// Selects a target from a list of units seen by spotter units for out-of-LOS actions
 	bool selectSpottedUnitForSniper();
 	/// Scores a firing mode action based on distance to target and accuracy.
@@ -0,0 +1,448 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleBenchmark.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "AIModule.h"
+#include "BattlescapeGenerator.h"
+#include "BattlescapeGame.h"
+#include "BattlescapeState.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Mod/AlienDeployment.h"
+#include "../Mod/Mod.h"
+#include "../Mod/RuleAlienMission.h"
+#include "../Mod/RuleCraft.h"
+#include "../Mod/RuleGlobe.h"
+#include "../Mod/RuleItem.h"
+#include "../Mod/RuleTerrain.h"
+#include "../Savegame/AlienBase.h"
+#include "../Savegame/Base.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Craft.h"
+#include "../Savegame/ItemContainer.h"
+#include "../Savegame/MissionSite.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/Soldier.h"
+#include "../Savegame/Ufo.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Upper limit of engine steps in one side's turn, guards against AI that never ends its turn.
+const int MaxStepsPerSide = 1000000;
+
+std::string getStringArg(const std::map<std::string, std::string> &args, const std::string &name, const std::string &def)
+{
+	auto i = args.find(name);
+	return i != args.end() ? i->second : def;
+}
+
+template<typename T>
+T getNumberArg(const std::map<std::string, std::string> &args, const std::string &name, T def)
+{
+	auto i = args.find(name);
+	if (i != args.end())
+	{
+		std::istringstream ss(i->second);
+		ss >> def;
+	}
+	return def;
+}
+
+const char *getSideName(UnitFaction side)
+{
+	switch (side)
+	{
+	case FACTION_PLAYER: return "xcom";
+	case FACTION_HOSTILE: return "aliens";
+	default: return "civilians";
+	}
+}
+
+/**
+ * Combines the state of all units into one number, so two runs
+ * with the same seed can be compared, eg. with different script loops.
+ */
+uint64_t getUnitsHash(SavedBattleGame *battle)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	auto add = [&](int value)
+	{
+		hash = (hash ^ (uint32_t)value) * 1099511628211ULL;
+	};
+	for (auto* unit : *battle->getUnits())
+	{
+		add(unit->getId());
+		add(unit->getFaction());
+		add(unit->getStatus());
+		add(unit->getHealth());
+		add(unit->getStunlevel());
+		add(unit->getTimeUnits());
+		add(unit->getPosition().x);
+		add(unit->getPosition().y);
+		add(unit->getPosition().z);
+	}
+	return hash;
+}
+
+}
+
+/**
+ * Sets up the benchmark.
+ * @param game Pointer to the core game, with mods already loaded.
+ * @param args Command line arguments (lowercase names without dashes).
+ */
+BattleBenchmark::BattleBenchmark(Game *game, const std::map<std::string, std::string> &args) : _game(game), _battleState(0)
+{
+	_deployment = getStringArg(args, "deployment", "STR_TERROR_MISSION");
+	_terrain = getStringArg(args, "terrain", "");
+	_alienRace = getStringArg(args, "race", "");
+	_craftType = getStringArg(args, "craft", "");
+	_seed = getNumberArg<uint64_t>(args, "seed", 1);
+	_turns = getNumberArg(args, "turns", 5);
+	_difficulty = getNumberArg(args, "difficulty", 0);
+	_alienItemLevel = getNumberArg(args, "alientech", 0);
+	_shade = getNumberArg(args, "shade", 0);
+	_depth = getNumberArg(args, "depth", 0);
+}
+
+/**
+ * Cleans up the benchmark.
+ */
+BattleBenchmark::~BattleBenchmark()
+{
+	Profiler::enabled = false;
+}
+
+/**
+ * Creates a new save with a single base, a craft filled
+ * with soldiers and the whole armory, and all research done.
+ * Mirrors what the "New Battle" screen does, without the interface.
+ * @return Craft that will go into battle.
+ */
+Craft *BattleBenchmark::initSave()
+{
+	Mod *mod = _game->getMod();
+	SavedGame *save = new SavedGame();
+	Base *base = new Base(mod);
+	base->load(mod->getDefaultStartingBase(), save, true, true);
+	save->getBases()->push_back(base);
+
+	for (std::vector<Soldier*>::iterator i = base->getSoldiers()->begin(); i != base->getSoldiers()->end(); ++i) delete (*i);
+	base->getSoldiers()->clear();
+	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
+	base->getCrafts()->clear();
+	base->getStorageItems()->clear();
+
+	if (_craftType.empty())
+	{
+		for (auto& type : mod->getCraftsList())
+		{
+			const RuleCraft *rule = mod->getCraft(type);
+			if (rule->getSoldiers() > 0 && rule->getAllowLanding())
+			{
+				_craftType = type;
+				break;
+			}
+		}
+	}
+	RuleCraft *craftRule = mod->getCraft(_craftType, true);
+	Craft *craft = new Craft(craftRule, base, 1);
+	base->getCrafts()->push_back(craft);
+
+	for (int i = 0; i < craftRule->getSoldiers(); ++i)
+	{
+		int randomType = RNG::generate(0, mod->getSoldiersList().size() - 1);
+		Soldier *soldier = mod->genSoldier(save, mod->getSoldiersList().at(randomType));
+		base->getSoldiers()->push_back(soldier);
+		soldier->setCraft(craft);
+	}
+
+	for (auto& type : mod->getItemsList())
+	{
+		RuleItem *rule = mod->getItem(type);
+		if (rule->getBattleType() != BT_CORPSE && rule->isRecoverable())
+		{
+			int howMany = rule->getBattleType() == BT_AMMO ? 2 : 1;
+			base->getStorageItems()->addItem(rule, howMany);
+			if (rule->getBattleType() != BT_NONE && rule->isInventoryItem())
+			{
+				craft->getItems()->addItem(rule, howMany);
+			}
+		}
+	}
+
+	for (auto& pair : mod->getResearchMap())
+	{
+		save->addFinishedResearchSimple(pair.second);
+	}
+
+	save->setDifficulty((GameDifficulty)_difficulty);
+	_game->setSavedGame(save);
+	return craft;
+}
+
+/**
+ * Generates the battle the same way the "New Battle" screen does
+ * and sets up the battlescape for AI-vs-AI play.
+ */
+void BattleBenchmark::generate()
+{
+	RNG::setSeed(_seed);
+
+	Mod *mod = _game->getMod();
+	AlienDeployment *deployment = mod->getDeployment(_deployment);
+	RuleUfo *ufoRule = mod->getUfo(_deployment);
+	if (!deployment && !ufoRule)
+	{
+		throw Exception("Unknown deployment: " + _deployment);
+	}
+	if (_terrain.empty())
+	{
+		std::vector<std::string> terrains = deployment ? deployment->getTerrains() : std::vector<std::string>();
+		if (terrains.empty())
+		{
+			terrains = mod->getGlobe()->getTerrains(deployment ? deployment->getType() : "");
+		}
+		if (terrains.empty())
+		{
+			terrains = mod->getTerrainList();
+		}
+		_terrain = terrains.front();
+	}
+	if (_alienRace.empty())
+	{
+		_alienRace = mod->getAlienRacesList().front();
+	}
+
+	Craft *craft = initSave();
+	SavedGame *save = _game->getSavedGame();
+	SavedBattleGame *battle = new SavedBattleGame(mod, _game->getLanguage());
+	save->setBattleGame(battle);
+	battle->setMissionType(_deployment);
+	BattlescapeGenerator bgen = BattlescapeGenerator(_game);
+	bgen.setTerrain(mod->getTerrain(_terrain, true));
+
+	if (_deployment == "STR_BASE_DEFENSE")
+	{
+		bgen.setBase(craft->getBase());
+		craft = 0;
+	}
+	else if (deployment && deployment->isAlienBase())
+	{
+		AlienBase *b = new AlienBase(deployment, -1);
+		b->setId(1);
+		b->setAlienRace(_alienRace);
+		craft->setDestination(b);
+		bgen.setAlienBase(b);
+		save->getAlienBases()->push_back(b);
+	}
+	else if (ufoRule)
+	{
+		Ufo *u = new Ufo(ufoRule, 1);
+		u->setId(1);
+		u->setStatus(Ufo::CRASHED);
+		craft->setDestination(u);
+		bgen.setUfo(u);
+		battle->setMissionType("STR_UFO_CRASH_RECOVERY");
+		save->getUfos()->push_back(u);
+	}
+	else
+	{
+		const RuleAlienMission *mission = mod->getAlienMission(mod->getAlienMissionList().front());
+		MissionSite *m = new MissionSite(mission, deployment, nullptr);
+		m->setId(1);
+		m->setAlienRace(_alienRace);
+		craft->setDestination(m);
+		bgen.setMissionSite(m);
+		save->getMissionSites()->push_back(m);
+	}
+
+	if (craft)
+	{
+		craft->setSpeed(0);
+		bgen.setCraft(craft);
+	}
+	bgen.setWorldShade(_shade);
+	bgen.setAlienRace(_alienRace);
+	bgen.setAlienItemlevel(_alienItemLevel);
+	battle->setDepth(_depth);
+	bgen.run();
+
+	Options::baseXResolution = Options::baseXBattlescape;
+	Options::baseYResolution = Options::baseYBattlescape;
+	_game->getScreen()->resetDisplay(false);
+
+	_battleState = new BattlescapeState;
+	_game->pushState(_battleState);
+	battle->setBattleState(_battleState);
+	_battleState->init();
+	_battleState->getBattleGame()->setPlayerAutoPlay(true);
+}
+
+/**
+ * Gives every player unit an AI module aimed at the aliens.
+ * A default AI module always hunts the player, so it can't be left
+ * to BattlescapeGame to create one for xcom units on autoplay.
+ */
+void BattleBenchmark::assignPlayerAI() const
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	for (auto* unit : *battle->getUnits())
+	{
+		if (unit->isOut() || unit->getFaction() != FACTION_PLAYER)
+		{
+			continue;
+		}
+		if (!unit->getAIModule())
+		{
+			unit->setAIModule(new AIModule(battle, unit, 0));
+		}
+		unit->getAIModule()->setTargetFaction(FACTION_HOSTILE);
+	}
+}
+
+/**
+ * Checks the conditions under which BattlescapeGame::endTurn
+ * ends the battle on its own (and pops the battlescape).
+ * @return True if the battle is over.
+ */
+bool BattleBenchmark::battleFinished() const
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	if (battle->allObjectivesDestroyed() && battle->getObjectiveType() == MUST_DESTROY)
+	{
+		return true;
+	}
+	return battle->getTurnLimit() > 0 && battle->getTurn() > battle->getTurnLimit();
+}
+
+/**
+ * Prints a line with the time spent in each profiled section.
+ * @param out Output stream.
+ * @param label Line label.
+ * @param wallMs Total wall clock time for the line.
+ */
+void BattleBenchmark::report(std::ostream &out, const std::string &label, double wallMs) const
+{
+	out << std::left << std::setw(18) << label << std::right << std::fixed << std::setprecision(1);
+	out << " total " << std::setw(9) << wallMs << " ms";
+	// only the battlescape sections, geoscape ones are never hit here
+	for (int i = 0; i <= PROF_AI_THINK; ++i)
+	{
+		ProfilerSection section = (ProfilerSection)i;
+		out << " | " << Profiler::getName(section) << " " << Profiler::getMilliseconds(section) << " ms/" << Profiler::getCounter(section).calls;
+	}
+	out << std::endl;
+}
+
+/**
+ * Lets the AI play every side until the turn limit is reached
+ * or the battle ends, printing one line of timings per side.
+ * Nothing is drawn, popups the interface would show are dropped.
+ * @param out Output stream for the report.
+ * @return Process exit code.
+ */
+int BattleBenchmark::run(std::ostream &out)
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	BattlescapeGame *battleGame = _battleState->getBattleGame();
+
+	int units = 0;
+	for (auto* unit : *battle->getUnits())
+	{
+		if (!unit->isOut()) ++units;
+	}
+	out << "Battle: " << _deployment << " terrain " << _terrain << " seed " << _seed;
+	out << " map " << battle->getMapSizeX() << "x" << battle->getMapSizeY() << "x" << battle->getMapSizeZ();
+	out << " units " << units << std::endl;
+
+	std::chrono::steady_clock::duration total = std::chrono::steady_clock::duration::zero();
+	int turn = battle->getTurn();
+	UnitFaction side = battle->getSide();
+	int steps = 0;
+	bool finished = false;
+	assignPlayerAI();
+
+	Profiler::reset();
+	Profiler::enabled = true;
+	auto start = std::chrono::steady_clock::now();
+	while (!finished)
+	{
+		battleGame->think();
+		battleGame->handleState();
+
+		if (battle->getTurn() == turn && battle->getSide() == side)
+		{
+			if (++steps > MaxStepsPerSide)
+			{
+				Log(LOG_ERROR) << "Side " << getSideName(side) << " did not finish its turn " << turn << ", stopping.";
+				return EXIT_FAILURE;
+			}
+			continue;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		total += now - start;
+		std::ostringstream label;
+		label << "turn " << turn << " " << getSideName(side);
+		report(out, label.str(), std::chrono::duration<double, std::milli>(now - start).count());
+
+		finished = battleFinished();
+		if (!finished)
+		{
+			// drop the "next turn" screen and other popups pushed by the engine
+			while (!_game->isState(_battleState))
+			{
+				_game->popState();
+			}
+			battleGame->cleanupDeleted();
+			assignPlayerAI();
+
+			auto tally = battleGame->tallyUnits();
+			finished = tally.liveAliens == 0 || tally.liveSoldiers == 0 || battle->getTurn() > _turns;
+		}
+
+		turn = battle->getTurn();
+		side = battle->getSide();
+		steps = 0;
+		Profiler::reset();
+		start = std::chrono::steady_clock::now();
+	}
+	Profiler::enabled = false;
+
+	out << "Total: " << std::fixed << std::setprecision(1) << std::chrono::duration<double, std::milli>(total).count() << " ms" << std::endl;
+	out << "Units hash: " << std::hex << getUnitsHash(battle) << std::dec << std::endl;
+	return EXIT_SUCCESS;
+}
+
+}
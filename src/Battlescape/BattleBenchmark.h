@@ -0,0 +1,66 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+class Game;
+class Craft;
+class BattlescapeState;
+
+/**
+ * Headless battlescape simulation used for performance measurements.
+ * Generates a battle from a deployment/terrain/seed and lets the AI
+ * play both sides for a number of turns, reporting how much time was
+ * spent in the expensive parts of the engine on every side's turn.
+ */
+class BattleBenchmark
+{
+private:
+	Game *_game;
+	std::string _deployment, _terrain, _alienRace, _craftType;
+	uint64_t _seed;
+	int _turns, _difficulty, _alienItemLevel, _shade, _depth;
+	BattlescapeState *_battleState;
+
+	/// Creates a new save with a base, a craft and soldiers.
+	Craft *initSave();
+	/// Gives every player unit an AI that hunts the aliens.
+	void assignPlayerAI() const;
+	/// Checks if the battle was ended by the engine itself.
+	bool battleFinished() const;
+	/// Prints timings collected since the last reset.
+	void report(std::ostream &out, const std::string &label, double wallMs) const;
+public:
+	/// Creates a benchmark with the settings from the command line.
+	BattleBenchmark(Game *game, const std::map<std::string, std::string> &args);
+	/// Cleans up the benchmark.
+	~BattleBenchmark();
+	/// Generates the battle.
+	void generate();
+	/// Plays the battle and reports timings.
+	int run(std::ostream &out);
+};
+
+}
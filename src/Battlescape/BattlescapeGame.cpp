@@ -178,7 +178,7 @@ bool BattleActionCost::spendTU(std::string *message)
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) :
 	_save(save), _parentState(parentState),
 	_playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false),
-	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
+	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false), _playerAutoPlay(false)
 {
 
 	_currentAction.actor = 0;
@@ -220,8 +220,8 @@ void BattlescapeGame::think()
 			_save->setUnitsFalling(false);
 			return;
 		}
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or the AI plays for the player too
+		if (_save->getSide() != FACTION_PLAYER || _playerAutoPlay)
 		{
 			_save->resetUnitHitStates();
 			if (!_debugPlay)
@@ -169,6 +169,7 @@ private:
 	bool _endTurnRequested;
 	bool _endConfirmationHandled;
 	bool _allEnemiesNeutralized;
+	bool _playerAutoPlay;
 
 	SingleRun _endTurnProcessed;
 	SingleRun _triggerProcessed;
@@ -198,6 +199,10 @@ public:
 	void init();
 	/// Determines whether a playable unit is selected.
 	bool playableUnitSelected() const;
+	/// Sets whether the AI also controls the player side.
+	void setPlayerAutoPlay(bool autoPlay) { _playerAutoPlay = autoPlay; }
+	/// Gets whether the AI also controls the player side.
+	bool getPlayerAutoPlay() const { return _playerAutoPlay; }
 	/// Handles states timer.
 	void handleState();
 	/// Pushes a state to the front of the list.
@@ -802,9 +802,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 	if (_base != 0)
 	{
 		ItemContainer *rememberMe = _save->getBaseStorageItems();
-		for (std::map<std::string, int>::iterator i = _base->getStorageItems()->getContents()->begin(); i != _base->getStorageItems()->getContents()->end(); ++i)
+		for (const auto& i : *_base->getStorageItems())
 		{
-			rememberMe->addItem(i->first, i->second);
+			rememberMe->addItem(i.first, i.second);
 		}
 	}
 
@@ -986,9 +986,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 	if (_craft != 0)
 	{
 		// add items that are in the craft
-		for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+		for (ItemContainer::const_iterator i = _craft->getItems()->begin(); i != _craft->getItems()->end(); ++i)
 		{
-			if (startingCondition != 0 && !startingCondition->isItemPermitted(i->first, _game->getMod(), _craft))
+			if (startingCondition != 0 && !startingCondition->isItemPermitted(i->first->getType(), _game->getMod(), _craft))
 			{
 				// send disabled items back to base
 				_base->getStorageItems()->addItem(i->first, i->second);
@@ -1008,9 +1008,9 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 		if (_game->getSavedGame()->getMonthsPassed() != -1)
 		{
 			// add items that are in the base
-			for (std::map<std::string, int>::iterator i = _base->getStorageItems()->getContents()->begin(); i != _base->getStorageItems()->getContents()->end();)
+			for (ItemContainer::const_iterator i = _base->getStorageItems()->begin(); i != _base->getStorageItems()->end(); ++i)
 			{
-				RuleItem *rule = _game->getMod()->getItem(i->first, true);
+				const RuleItem *rule = i->first;
 				if (
 					// is item allowed in base defense?
 					rule->canBeEquippedBeforeBaseDefense() &&
@@ -1026,17 +1026,12 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 					{
 						_save->createItemForTile(i->first, _craftInventoryTile);
 					}
-					std::map<std::string, int>::iterator tmp = i;
-					++i;
 					if (!_baseInventory)
 					{
-						_base->getStorageItems()->removeItem(tmp->first, tmp->second);
+						// emptying the current slot does not invalidate the iterator
+						_base->getStorageItems()->removeItem(i->first, i->second);
 					}
 				}
-				else
-				{
-					++i;
-				}
 			}
 		}
 		// add items from crafts in base
@@ -1044,7 +1039,7 @@ void BattlescapeGenerator::deployXCOM(const RuleStartingCondition* startingCondi
 		{
 			if ((*c)->getStatus() == "STR_OUT")
 				continue;
-			for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+			for (ItemContainer::const_iterator i = (*c)->getItems()->begin(); i != (*c)->getItems()->end(); ++i)
 			{
 				for (int count = 0; count < i->second; count++)
 				{
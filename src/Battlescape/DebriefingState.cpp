@@ -60,6 +60,7 @@
 #include "../Menu/MainMenuState.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
 #include "../Engine/Options.h"
 #include "../Engine/RNG.h"
 #include "../Basescape/ManageAlienContainmentState.h"
@@ -323,11 +324,10 @@ DebriefingState::DebriefingState() : _region(0), _country(0), _positiveScore(tru
 		const std::vector<std::string> &items = _game->getMod()->getItemsList();
 		for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 		{
-			int qty = _base->getStorageItems()->getItem(*i);
-			if (qty > 0 && (Options::canSellLiveAliens || !_game->getMod()->getItem(*i)->isAlien()))
+			RuleItem *rule = _game->getMod()->getItem(*i);
+			int qty = _base->getStorageItems()->getItem(rule);
+			if (qty > 0 && (Options::canSellLiveAliens || !rule->isAlien()))
 			{
-				RuleItem *rule = _game->getMod()->getItem(*i);
-
 				// IGNORE vehicles and their ammo
 				// Note: because their number in base has been messed up by Base::setupDefenses() already in geoscape :(
 				if (rule->getVehicleUnit())
@@ -340,7 +340,7 @@ DebriefingState::DebriefingState() : _region(0), _country(0), _positiveScore(tru
 					continue;
 				}
 
-				qty -= origBaseItems->getItem(*i);
+				qty -= origBaseItems->getItem(rule);
 				if (qty > 0)
 				{
 					_recoveredItems[rule] = qty;
@@ -2113,8 +2113,7 @@ void DebriefingState::prepareDebriefing()
  */
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
-	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
+	for (ItemContainer::const_iterator i = craft->getItems()->begin(); i != craft->getItems()->end(); ++i)
 	{
 		int qty = base->getStorageItems()->getItem(i->first);
 		if (qty >= i->second)
@@ -2123,10 +2122,11 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 		}
 		else
 		{
+			// the iterator keeps its own copy of the current item, so shrinking the craft slot is safe
 			int missing = i->second - qty;
 			base->getStorageItems()->removeItem(i->first, qty);
 			craft->getItems()->removeItem(i->first, missing);
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage()), 0};
+			ReequipStat stat = {i->first->getType(), missing, craft->getName(_game->getLanguage()), 0};
 			_missingItems.push_back(stat);
 		}
 	}
@@ -2142,16 +2142,16 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now read those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	for (ItemContainer::const_iterator i = craftVehicles.begin(); i != craftVehicles.end(); ++i)
 	{
 		int qty = base->getStorageItems()->getItem(i->first);
-		RuleItem *tankRule = _game->getMod()->getItem(i->first, true);
+		RuleItem *tankRule = _game->getMod()->getItem(i->first->getType(), true);
 		int size = tankRule->getVehicleUnit()->getArmor()->getTotalSize();
 		int canBeAdded = std::min(qty, i->second);
 		if (qty < i->second)
 		{ // missing tanks
 			int missing = i->second - qty;
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage()), 0};
+			ReequipStat stat = {tankRule->getType(), missing, craft->getName(_game->getLanguage()), 0};
 			_missingItems.push_back(stat);
 		}
 		if (tankRule->getVehicleClipAmmo() == nullptr)
@@ -2197,7 +2197,7 @@ void DebriefingState::addItemsToBaseStores(const RuleItem *ruleItem, Base *base,
 {
 	if (!considerTransformations)
 	{
-		base->getStorageItems()->addItem(ruleItem->getType(), quantity);
+		base->getStorageItems()->addItem(ruleItem, quantity);
 	}
 	else
 	{
@@ -2224,7 +2224,7 @@ void DebriefingState::addItemsToBaseStores(const RuleItem *ruleItem, Base *base,
 							runningTotal += (*it);
 							if (runningTotal >= roll)
 							{
-								base->getStorageItems()->addItem(pair.first->getType(), position);
+								base->getStorageItems()->addItem(pair.first, position);
 								break;
 							}
 							++position;
@@ -2234,13 +2234,13 @@ void DebriefingState::addItemsToBaseStores(const RuleItem *ruleItem, Base *base,
 				else
 				{
 					// no RNG
-					base->getStorageItems()->addItem(pair.first->getType(), quantity * pair.second.front());
+					base->getStorageItems()->addItem(pair.first, quantity * pair.second.front());
 				}
 			}
 		}
 		else
 		{
-			base->getStorageItems()->addItem(ruleItem->getType(), quantity);
+			base->getStorageItems()->addItem(ruleItem, quantity);
 		}
 	}
 }
@@ -2254,22 +2254,15 @@ void DebriefingState::addItemsToBaseStores(const RuleItem *ruleItem, Base *base,
  */
 void DebriefingState::addItemsToBaseStores(const std::string &itemType, Base *base, int quantity, bool considerTransformations)
 {
-	if (!considerTransformations)
+	const RuleItem *ruleItem = _game->getMod()->getItem(itemType, false);
+	if (ruleItem)
 	{
-		base->getStorageItems()->addItem(itemType, quantity);
+		addItemsToBaseStores(ruleItem, base, quantity, considerTransformations);
 	}
 	else
 	{
-		const RuleItem *ruleItem = _game->getMod()->getItem(itemType, false);
-		if (ruleItem)
-		{
-			addItemsToBaseStores(ruleItem, base, quantity, considerTransformations);
-		}
-		else
-		{
-			// unknown item?
-			base->getStorageItems()->addItem(itemType, quantity);
-		}
+		// unknown item, stores can only hold items the mod knows about
+		Log(LOG_ERROR) << "Failed to recover unknown item " << itemType;
 	}
 }
 
@@ -19,12 +19,12 @@
 #include <list>
 #include <algorithm>
 #include "Pathfinding.h"
-#include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Mod/Armor.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "BattlescapeGame.h"
 #include "TileEngine.h"
 
@@ -43,20 +43,18 @@ int Pathfinding::green = 4;
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _searchId(0), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
-	_nodes.reserve(_size);
-	for (int i = 0; i < _size; ++i)
-	{
-		_nodes.push_back(PathfindingNode(_save->getTileCoords(i)));
-	}
+	_nodeState.resize(_size, 0);
+	_nodeTUCost.resize(_size, 0);
+	_nodePrev.resize(_size, -1);
+	_nodePrevDir.resize(_size, 0);
 }
 
 /**
  * Deletes the Pathfinding.
- * @internal This is required to be here because it requires the PathfindingNode class definition.
  */
 Pathfinding::~Pathfinding()
 {
@@ -64,13 +62,35 @@ Pathfinding::~Pathfinding()
 }
 
 /**
- * Gets the Node on a given position on the map.
- * @param pos Position.
- * @return Pointer to node.
+ * Starts a new search. Nodes are not touched, the states
+ * left by older searches just stop matching the new search id.
+ */
+void Pathfinding::resetNodes()
+{
+	_openSet.clear();
+	++_searchId;
+	if (_searchId > 0x7FFFFFFE)
+	{
+		// ids ran out, so forget the old states for real.
+		std::fill(_nodeState.begin(), _nodeState.end(), 0);
+		_searchId = 1;
+	}
+}
+
+/**
+ * Connects the node to the previous node along the path
+ * and puts it in the open set of the current search.
+ * @param node Index of the node.
+ * @param tuCost The total cost of the path so far.
+ * @param prevNode Index of the previous node along the path, or -1 at the start.
+ * @param prevDir The direction FROM the previous node.
  */
-PathfindingNode *Pathfinding::getNode(Position pos)
+void Pathfinding::connectNode(int node, int tuCost, int prevNode, int prevDir)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	_nodeState[node] = 2 * _searchId;
+	_nodeTUCost[node] = tuCost;
+	_nodePrev[node] = prevNode;
+	_nodePrevDir[node] = prevDir;
 }
 
 /**
@@ -82,10 +102,10 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	Profiler::Scope profile(PROF_PATHFINDING_CALCULATE);
+
 	_totalTUCost = 0;
 	_path.clear();
-	// i'm DONE with these out of bounds errors.
-	if (endPosition.x > _save->getMapSizeX() - unit->getArmor()->getSize() || endPosition.y > _save->getMapSizeY() - unit->getArmor()->getSize() || endPosition.x < 0 || endPosition.y < 0) return;
 
 	bool sneak = Options::sneakyAI && unit->getFaction() == FACTION_HOSTILE;
 
@@ -98,14 +118,52 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 	}
 	_unit = unit;
 
+	if (!adjustDestination(unit, _movementType, endPosition, target)) return;
+
+	// Strafing move allowed only to adjacent squares on same z. "Same z" rule mainly to simplify walking render.
+	_strafeMove = Options::strafe && (SDL_GetModState() & KMOD_CTRL) != 0 && (startPosition.z == endPosition.z) &&
+							(abs(startPosition.x - endPosition.x) <= 1) && (abs(startPosition.y - endPosition.y) <= 1);
+
+	// look for a possible fast and accurate bresenham path and skip A*
+	if (startPosition.z == endPosition.z && bresenhamPath(startPosition,endPosition, target, sneak))
+	{
+		std::reverse(_path.begin(), _path.end()); //paths are stored in reverse order
+		return;
+	}
+	else
+	{
+		abortPath(); // if bresenham failed, we shouldn't keep the path it was attempting, in case A* fails too.
+	}
+	// Now try through A*.
+	if (!aStarPath(startPosition, endPosition, target, sneak, maxTUCost))
+	{
+		abortPath();
+	}
+}
+
+/**
+ * Moves a destination to the tile a unit would actually stop on,
+ * like going up stairs or falling down to the floor below.
+ * @param unit The unit moving.
+ * @param movementType Movement type used for the path.
+ * @param endPosition The position we want to reach, changed to where the path ends.
+ * @param missileTarget Target of the path, for missiles.
+ * @return False if the destination can't be reached at all.
+ */
+bool Pathfinding::adjustDestination(BattleUnit *unit, MovementType movementType, Position &endPosition, BattleUnit *missileTarget) const
+{
+	// i'm DONE with these out of bounds errors.
+	if (endPosition.x > _save->getMapSizeX() - unit->getArmor()->getSize() || endPosition.y > _save->getMapSizeY() - unit->getArmor()->getSize() || endPosition.x < 0 || endPosition.y < 0) return false;
+
 	Tile *destinationTile = _save->getTile(endPosition);
+	if (destinationTile == 0) return false;
 
 	// check if destination is not blocked
-	if (isBlocked(destinationTile, O_FLOOR, target) || isBlocked(destinationTile, O_OBJECT, target)) return;
+	if (isBlocked(unit, movementType, destinationTile, O_FLOOR, missileTarget) || isBlocked(unit, movementType, destinationTile, O_OBJECT, missileTarget)) return false;
 
 	// the following check avoids that the unit walks behind the stairs if we click behind the stairs to make it go up the stairs.
 	// it only works if the unit is on one of the 2 tiles on the stairs, or on the tile right in front of the stairs.
-	if (isOnStairs(startPosition, endPosition))
+	if (isOnStairs(unit->getPosition(), endPosition))
 	{
 		endPosition.z++;
 		destinationTile = _save->getTile(endPosition);
@@ -120,36 +178,81 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 	// and is considered passable terrain for whatever reason (usually bigwall type objects)
 	if (endPosition.z == _save->getMapSizeZ())
 	{
-		return; // Icarus is a bad role model for XCom soldiers.
+		return false; // Icarus is a bad role model for XCom soldiers.
 	}
 	// check if we have floor, else lower destination (for non flying units only, because otherwise they never reached this place)
-	while (canFallDown(destinationTile, _unit->getArmor()->getSize()) && _movementType != MT_FLY)
+	while (canFallDown(destinationTile, unit->getArmor()->getSize()) && movementType != MT_FLY)
 	{
 		endPosition.z--;
 		destinationTile = _save->getTile(endPosition);
 	}
 	// check if destination is not blocked
-	if (isBlocked(destinationTile, O_FLOOR, target) || isBlocked(destinationTile, O_OBJECT, target)) return;
+	return !isBlocked(unit, movementType, destinationTile, O_FLOOR, missileTarget) && !isBlocked(unit, movementType, destinationTile, O_OBJECT, missileTarget);
+}
 
-	// Strafing move allowed only to adjacent squares on same z. "Same z" rule mainly to simplify walking render.
-	_strafeMove = Options::strafe && (SDL_GetModState() & KMOD_CTRL) != 0 && (startPosition.z == endPosition.z) &&
-							(abs(startPosition.x - endPosition.x) <= 1) && (abs(startPosition.y - endPosition.y) <= 1);
+/**
+ * Calculates the cheapest paths from the position of a unit to all tiles of the map
+ * using Dijkstra's algorithm, with the same step costs as calculate() uses.
+ * @param field Field to store the result in.
+ * @param unit Unit taking the paths.
+ * @param maxTUCost Maximum time units a path can cost.
+ */
+void Pathfinding::calculateCostField(PathfindingCostField &field, BattleUnit *unit, int maxTUCost)
+{
+	Profiler::Scope profile(PROF_PATHFINDING_COST_FIELD);
+
+	field._save = _save;
+	field._pathfinding = this;
+	field._unit = unit;
+	field._origin = unit->getPosition();
+	field._maxTUCost = maxTUCost;
+	field._tuCost.assign(_size, -1);
+	field._prevIndex.assign(_size, -1);
+	field._prevDir.assign(_size, -1);
+	field._steps.assign(_size, 0);
 
-	// look for a possible fast and accurate bresenham path and skip A*
-	if (startPosition.z == endPosition.z && bresenhamPath(startPosition,endPosition, target, sneak))
-	{
-		std::reverse(_path.begin(), _path.end()); //paths are stored in reverse order
-		return;
-	}
-	else
-	{
-		abortPath(); // if bresenham failed, we shouldn't keep the path it was attempting, in case A* fails too.
-	}
-	// Now try through A*.
-	if (!aStarPath(startPosition, endPosition, target, sneak, maxTUCost))
+	bool sneak = Options::sneakyAI && unit->getFaction() == FACTION_HOSTILE;
+	bool strafeMove = _strafeMove;
+	_strafeMove = false;
+	_movementType = unit->getMovementType();
+	_unit = unit;
+	field._movementType = _movementType;
+
+	_openSet.clear();
+	int startIndex = _save->getTileIndex(field._origin);
+	field._tuCost[startIndex] = 0;
+	_openSet.push(startIndex, 0);
+	while (!_openSet.empty())
 	{
-		abortPath();
+		int currentCost;
+		int currentIndex = _openSet.pop(currentCost);
+		if (currentCost != field._tuCost[currentIndex]) // Outdated entry, the node was reached cheaper since.
+			continue;
+		Position currentPos = _save->getTileCoords(currentIndex);
+
+		// Try all reachable neighbours.
+		for (int direction = 0; direction < 10; direction++)
+		{
+			Position nextPos;
+			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
+			if (tuCost >= 255) // Skip unreachable / blocked
+				continue;
+			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
+			int nextIndex = _save->getTileIndex(nextPos);
+			int totalTuCost = currentCost + tuCost;
+			// Checked nodes are already at minimum cost, so this skips them too.
+			if (totalTuCost <= maxTUCost && (field._tuCost[nextIndex] == -1 || field._tuCost[nextIndex] > totalTuCost))
+			{
+				field._tuCost[nextIndex] = totalTuCost;
+				field._prevIndex[nextIndex] = currentIndex;
+				field._prevDir[nextIndex] = direction;
+				field._steps[nextIndex] = field._steps[currentIndex] + 1;
+				_openSet.push(nextIndex, totalTuCost);
+			}
+		}
 	}
+	_openSet.clear();
+	_strafeMove = strafeMove;
 }
 
 /**
@@ -165,33 +268,38 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  */
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	// only nodes touched by this search count, older states are ignored
+	resetNodes();
 
 	// start position is the first one in our "open" list
-	PathfindingNode *start = getNode(startPosition);
-	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
-	openList.push(start);
+	int start = _save->getTileIndex(startPosition);
+	connectNode(start, 0, -1, 0);
+	int startGuess = 4 * Position::distance(endPosition, startPosition);
+	_openSet.push(start, startGuess);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
-	while (!openList.empty())
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = openList.pop();
-		Position const &currentPos = currentNode->getPosition();
-		currentNode->setChecked();
+		int currentCost;
+		int currentNode = _openSet.pop(currentCost);
+		if (!isNodeOpen(currentNode)) // Outdated entry of a node checked before.
+			continue;
+		const Position currentPos = _save->getTileCoords(currentNode);
+		int currentGuess = 4 * Position::distance(endPosition, currentPos); // truncated the same way as when pushed
+		if (currentCost != _nodeTUCost[currentNode] + currentGuess) // Outdated entry, the node was reached cheaper since.
+			continue;
+		_nodeState[currentNode] = 2 * _searchId + 1;
 		if (currentPos == endPosition) // We found our target.
 		{
 			_path.clear();
-			PathfindingNode *pf = currentNode;
-			while (pf->getPrevNode())
+			for (int pf = currentNode; _nodePrev[pf] != -1; pf = _nodePrev[pf])
 			{
-				_path.push_back(pf->getPrevDir());
-				pf = pf->getPrevNode();
+				_path.push_back(_nodePrevDir[pf]);
 			}
+			_openSet.clear();
 			return true;
 		}
+		int currentTUCost = missile ? 0 : _nodeTUCost[currentNode];
 
 		// Try all reachable neighbours.
 		for (int direction = 0; direction < 10; direction++)
@@ -201,15 +309,16 @@ bool Pathfinding::aStarPath(Position startPosition, Position endPosition, Battle
 			if (tuCost >= 255) // Skip unreachable / blocked
 				continue;
 			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
-			PathfindingNode *nextNode = getNode(nextPos);
-			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
+			int nextNode = _save->getTileIndex(nextPos);
+			if (isNodeChecked(nextNode)) // Our algorithm means this node is already at minimum cost.
 				continue;
-			_totalTUCost = currentNode->getTUCost(missile) + tuCost;
+			_totalTUCost = currentTUCost + tuCost;
 			// If this node is unvisited or has only been visited from inferior paths...
-			if ((!nextNode->inOpenSet() || nextNode->getTUCost(missile) > _totalTUCost) && _totalTUCost <= maxTUCost)
+			if ((!isNodeOpen(nextNode) || (missile ? 0 : _nodeTUCost[nextNode]) > _totalTUCost) && _totalTUCost <= maxTUCost)
 			{
-				nextNode->connect(_totalTUCost, currentNode, direction, endPosition);
-				openList.push(nextNode);
+				connectNode(nextNode, _totalTUCost, currentNode, direction);
+				int nextGuess = 4 * Position::distance(endPosition, nextPos);
+				_openSet.push(nextNode, _totalTUCost + nextGuess);
 			}
 		}
 	}
@@ -278,7 +387,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		if (direction < DIR_UP && startTile[i]->getTerrainLevel() > - 16)
 		{
 			// check if we can go this way
-			if (isBlockedDirection(startTile[i], direction, target))
+			if (isBlockedDirectionCached(startTile[i], direction, target))
 				return 255;
 			if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 				return 255;
@@ -369,7 +478,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		if (direction < DIR_UP && sameLevel)
 		{
 			// check if we can go this way
-			if (isBlockedDirection(startTile[i], direction, target))
+			if (isBlockedDirectionCached(startTile[i], direction, target))
 				return 255;
 			if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 				return 255;
@@ -393,7 +502,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 			if (direction < DIR_UP)
 			{
 				// check if we can go this way
-				if (isBlockedDirection(startTile[i], direction, target))
+				if (isBlockedDirectionCached(startTile[i], direction, target))
 					return 255;
 				if (startTile[i]->getTerrainLevel() - destinationTile[i]->getTerrainLevel() > 8)
 					return 255;
@@ -475,14 +584,14 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		Tile *originTile = _save->getTile(*endPosition + Position(1,1,0));
 		Tile *finalTile = _save->getTile(*endPosition);
 		int tmpDirection = 7;
-		if (isBlockedDirection(originTile, tmpDirection, target))
+		if (isBlockedDirectionCached(originTile, tmpDirection, target))
 			return 255;
 		if (!fellDown && abs(originTile->getTerrainLevel() - finalTile->getTerrainLevel()) > 10)
 			return 255;
 		originTile = _save->getTile(*endPosition + Position(1,0,0));
 		finalTile = _save->getTile(*endPosition + Position(0,1,0));
 		tmpDirection = 5;
-		if (isBlockedDirection(originTile, tmpDirection, target))
+		if (isBlockedDirectionCached(originTile, tmpDirection, target))
 			return 255;
 		if (!fellDown && abs(originTile->getTerrainLevel() - finalTile->getTerrainLevel()) > 10)
 			return 255;
@@ -553,13 +662,28 @@ void Pathfinding::abortPath()
 
 
 /**
- * Determines whether a certain part of a tile blocks movement.
+ * Determines whether a certain part of a tile blocks movement
+ * of the unit the last path was calculated for.
  * @param tile Specified tile, can be a null pointer.
  * @param part Part of the tile.
  * @param missileTarget Target for a missile.
  * @return True if the movement is blocked.
  */
 bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion) const
+{
+	return isBlocked(_unit, _movementType, tile, part, missileTarget, bigWallExclusion);
+}
+
+/**
+ * Determines whether a certain part of a tile blocks movement.
+ * @param movingUnit Unit that moves, can be a null pointer.
+ * @param movementType Movement type of the unit.
+ * @param tile Specified tile, can be a null pointer.
+ * @param part Part of the tile.
+ * @param missileTarget Target for a missile.
+ * @return True if the movement is blocked.
+ */
+bool Pathfinding::isBlocked(BattleUnit *movingUnit, MovementType movementType, Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion) const
 {
 	if (tile == 0) return true; // probably outside the map here
 
@@ -604,18 +728,18 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 		if (tile->getUnit())
 		{
 			BattleUnit *unit = tile->getUnit();
-			if (unit == _unit || unit == missileTarget || unit->isOut()) return false;
+			if (unit == movingUnit || unit == missileTarget || unit->isOut()) return false;
 			if (missileTarget && unit != missileTarget && unit->getFaction() == FACTION_HOSTILE)
 				return true;			// AI pathfinding with missiles shouldn't path through their own units
-			if (_unit)
+			if (movingUnit)
 			{
-				if (_unit->getFaction() == FACTION_PLAYER && unit->getVisible()) return true;		// player know all visible units
-				if (_unit->getFaction() == unit->getFaction()) return true;
-				if (_unit->getFaction() == FACTION_HOSTILE &&
-					std::find(_unit->getUnitsSpottedThisTurn().begin(), _unit->getUnitsSpottedThisTurn().end(), unit) != _unit->getUnitsSpottedThisTurn().end()) return true;
+				if (movingUnit->getFaction() == FACTION_PLAYER && unit->getVisible()) return true;		// player know all visible units
+				if (movingUnit->getFaction() == unit->getFaction()) return true;
+				if (movingUnit->getFaction() == FACTION_HOSTILE &&
+					std::find(movingUnit->getUnitsSpottedThisTurn().begin(), movingUnit->getUnitsSpottedThisTurn().end(), unit) != movingUnit->getUnitsSpottedThisTurn().end()) return true;
 			}
 		}
-		else if (tile->hasNoFloor(0) && _movementType != MT_FLY) // this whole section is devoted to making large units not take part in any kind of falling behaviour
+		else if (tile->hasNoFloor(0) && movementType != MT_FLY) // this whole section is devoted to making large units not take part in any kind of falling behaviour
 		{
 			Position pos = tile->getPosition();
 			while (pos.z >= 0)
@@ -623,15 +747,15 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 				Tile *t = _save->getTile(pos);
 				BattleUnit *unit = t->getUnit();
 
-				if (unit != 0 && unit != _unit)
+				if (unit != 0 && unit != movingUnit)
 				{
 					// don't let large units fall on other units
-					if (_unit && _unit->getArmor()->getSize() > 1)
+					if (movingUnit && movingUnit->getArmor()->getSize() > 1)
 					{
 						return true;
 					}
 					// don't let any units fall on large units
-					if (unit != _unit && unit != missileTarget && !unit->isOut() && unit->getArmor()->getSize() > 1)
+					if (unit != movingUnit && unit != missileTarget && !unit->isOut() && unit->getArmor()->getSize() > 1)
 					{
 						return true;
 					}
@@ -654,7 +778,7 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 	{
 		return true;
 	}}
-	if (tile->getTUCost(part, _movementType) == 255) return true; // blocking part
+	if (tile->getTUCost(part, movementType) == 255) return true; // blocking part
 	return false;
 }
 
@@ -730,6 +854,73 @@ bool Pathfinding::isBlockedDirection(Tile *startTile, const int direction, Battl
 	return false;
 }
 
+/**
+ * Determines whether going from one tile to another blocks movement.
+ * Walls don't depend on the unit, only on the movement type, so the result
+ * for all directions of the tile is kept until the terrain around it changes.
+ * Missiles also care about doors, so they always check the tiles.
+ * @param startTile The tile to start from.
+ * @param direction The direction we are facing.
+ * @param missileTarget Target for a missile.
+ * @return True if the movement is blocked.
+ */
+bool Pathfinding::isBlockedDirectionCached(Tile *startTile, const int direction, BattleUnit *missileTarget)
+{
+	if (missileTarget != 0)
+	{
+		return isBlockedDirection(startTile, direction, missileTarget);
+	}
+
+	std::vector<Uint16> &cache = _blockedDirections[_movementType];
+	if (cache.empty())
+	{
+		cache.resize(_size, 0);
+	}
+	Uint16 &blocked = cache[_save->getTileIndex(startTile->getPosition())];
+	if (!(blocked & 0x100))
+	{
+		blocked = 0x100;
+		for (int dir = 0; dir < 8; ++dir)
+		{
+			if (isBlockedDirection(startTile, dir, 0))
+			{
+				blocked |= 1 << dir;
+			}
+		}
+	}
+	return (blocked & (1 << direction)) != 0;
+}
+
+/**
+ * Forgets the cached terrain blockage of the tiles that can see walls of the changed tiles.
+ * Blockage from a tile looks at its neighbours on the same level, so those are cleared too.
+ * @param position Centre of the changed tiles.
+ * @param radius How far from the centre tiles changed.
+ */
+void Pathfinding::invalidateTerrainCache(Position position, int radius)
+{
+	const int minX = std::max(0, position.x - radius - 1), maxX = std::min(_save->getMapSizeX() - 1, position.x + radius + 1);
+	const int minY = std::max(0, position.y - radius - 1), maxY = std::min(_save->getMapSizeY() - 1, position.y + radius + 1);
+	const int minZ = std::max(0, position.z - radius), maxZ = std::min(_save->getMapSizeZ() - 1, position.z + radius);
+	for (auto &cache : _blockedDirections)
+	{
+		if (cache.empty())
+		{
+			continue;
+		}
+		for (int z = minZ; z <= maxZ; ++z)
+		{
+			for (int y = minY; y <= maxY; ++y)
+			{
+				for (int x = minX; x <= maxX; ++x)
+				{
+					cache[_save->getTileIndex(Position(x, y, z))] = 0;
+				}
+			}
+		}
+	}
+}
+
 /**
  * Determines whether a unit can fall down from this tile.
  * We can fall down here, if the tile does not exist, the tile has no floor
@@ -1146,22 +1337,23 @@ bool Pathfinding::bresenhamPath(Position origin, Position target, BattleUnit *ta
  */
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleActionCost &cost)
 {
+	Profiler::Scope profile(PROF_PATHFINDING_REACHABLE);
+
 	const Position start = unit->getPosition();
 	int tuMax = unit->getTimeUnits() - cost.Time;
 	int energyMax = unit->getEnergy() - cost.Energy;
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
-	PathfindingNode *startNode = getNode(start);
-	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
-	unvisited.push(startNode);
-	std::vector<PathfindingNode*> reachable;
-	while (!unvisited.empty())
+	resetNodes();
+	int startNode = _save->getTileIndex(start);
+	connectNode(startNode, 0, -1, 0);
+	_openSet.push(startNode, 0);
+	std::vector<int> tiles;
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = unvisited.pop();
-		Position const &currentPos = currentNode->getPosition();
+		int currentCost;
+		int currentNode = _openSet.pop(currentCost);
+		if (!isNodeOpen(currentNode) || currentCost != _nodeTUCost[currentNode]) // Outdated entry.
+			continue;
+		const Position currentPos = _save->getTileCoords(currentNode);
 
 		// Try all reachable neighbours.
 		for (int direction = 0; direction < 10; direction++)
@@ -1170,31 +1362,92 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleAction
 			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
 			if (tuCost == 255) // Skip unreachable / blocked
 				continue;
-			if (currentNode->getTUCost(false) + tuCost > tuMax ||
-				(currentNode->getTUCost(false) + tuCost) / 2 > energyMax) // Run out of TUs/Energy
+			if (currentCost + tuCost > tuMax ||
+				(currentCost + tuCost) / 2 > energyMax) // Run out of TUs/Energy
 				continue;
-			PathfindingNode *nextNode = getNode(nextPos);
-			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
+			int nextNode = _save->getTileIndex(nextPos);
+			if (isNodeChecked(nextNode)) // Our algorithm means this node is already at minimum cost.
 				continue;
-			int totalTuCost = currentNode->getTUCost(false) + tuCost;
+			int totalTuCost = currentCost + tuCost;
 			// If this node is unvisited or visited from a better path.
-			if (!nextNode->inOpenSet() || nextNode->getTUCost(false) > totalTuCost)
+			if (!isNodeOpen(nextNode) || _nodeTUCost[nextNode] > totalTuCost)
 			{
-				nextNode->connect(totalTuCost, currentNode, direction);
-				unvisited.push(nextNode);
+				connectNode(nextNode, totalTuCost, currentNode, direction);
+				_openSet.push(nextNode, totalTuCost);
 			}
 		}
-		currentNode->setChecked();
-		reachable.push_back(currentNode);
+		_nodeState[currentNode] = 2 * _searchId + 1;
+		// nodes leave the open set in order of cost, so the list stays sorted.
+		tiles.push_back(currentNode);
 	}
-	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
-	tiles.reserve(reachable.size());
-	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
+	return tiles;
+}
+
+/**
+ * Creates an empty cost field, not valid for any unit.
+ */
+PathfindingCostField::PathfindingCostField() : _save(0), _pathfinding(0), _unit(0), _movementType(MT_WALK), _maxTUCost(0)
+{
+}
+
+/**
+ * Gets the tile index of a position the field has a path to.
+ * The position is moved first the same way Pathfinding::calculate
+ * moves its destination, eg. down to the floor for walking units.
+ * @param pos Position to check.
+ * @return Tile index or -1 if the position is outside the map or can't be reached.
+ */
+int PathfindingCostField::getReachedIndex(Position pos) const
+{
+	if (!_unit || !_save->getTile(pos) || !_pathfinding->adjustDestination(_unit, _movementType, pos, 0))
 	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		return -1;
 	}
-	return tiles;
+	int index = _save->getTileIndex(pos);
+	return _tuCost[index] == -1 ? -1 : index;
+}
+
+/**
+ * Gets the TU cost of the cheapest path to a position.
+ * @param pos Position to reach.
+ * @return TU cost, 0 for the origin or -1 if the position can't be reached.
+ */
+int PathfindingCostField::getTUCost(Position pos) const
+{
+	int index = getReachedIndex(pos);
+	return index == -1 ? -1 : _tuCost[index];
+}
+
+/**
+ * Gets the number of steps of the cheapest path to a position.
+ * @param pos Position to reach.
+ * @return Number of steps, 0 for the origin or -1 if the position can't be reached.
+ */
+int PathfindingCostField::getPathLength(Position pos) const
+{
+	int index = getReachedIndex(pos);
+	return index == -1 ? -1 : _steps[index];
+}
+
+/**
+ * Gets the cheapest path to a position.
+ * @param pos Position to reach.
+ * @return Directions of the path in reverse order, like Pathfinding::getPath, empty if the position can't be reached.
+ */
+std::vector<int> PathfindingCostField::getPath(Position pos) const
+{
+	std::vector<int> path;
+	int index = getReachedIndex(pos);
+	if (index != -1)
+	{
+		path.reserve(_steps[index]);
+		while (_prevIndex[index] != -1)
+		{
+			path.push_back(_prevDir[index]);
+			index = _prevIndex[index];
+		}
+	}
+	return path;
 }
 
 /**
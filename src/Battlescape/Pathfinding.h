@@ -19,7 +19,7 @@
  */
 #include <vector>
 #include "Position.h"
-#include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Mod/MapData.h"
 
 namespace OpenXcom
@@ -29,6 +29,42 @@ class SavedBattleGame;
 class Tile;
 class BattleUnit;
 struct BattleActionCost;
+class Pathfinding;
+
+/**
+ * TU costs of the cheapest paths from the position of a unit to every tile of the map.
+ * Calculated once by Pathfinding::calculateCostField, then used to answer many path
+ * queries from the same origin without searching again.
+ */
+class PathfindingCostField
+{
+private:
+	friend class Pathfinding;
+	SavedBattleGame *_save;
+	const Pathfinding *_pathfinding;
+	BattleUnit *_unit;
+	MovementType _movementType;
+	Position _origin;
+	int _maxTUCost;
+	std::vector<int> _tuCost, _prevIndex;
+	std::vector<Sint8> _prevDir;
+	std::vector<Uint16> _steps;
+	/// Gets the index of a position, or -1 if it is not reachable.
+	int getReachedIndex(Position pos) const;
+public:
+	/// Creates an empty cost field.
+	PathfindingCostField();
+	/// Checks if the field was calculated for a unit standing at a position.
+	bool isValidFor(const BattleUnit *unit, Position origin, int maxTUCost = 1000) const { return _unit == unit && _origin == origin && _maxTUCost == maxTUCost; }
+	/// Invalidates the field.
+	void clear() { _unit = 0; }
+	/// Gets the TU cost of the cheapest path to a position.
+	int getTUCost(Position pos) const;
+	/// Gets the number of steps of the cheapest path to a position.
+	int getPathLength(Position pos) const;
+	/// Gets the cheapest path to a position.
+	std::vector<int> getPath(Position pos) const;
+};
 
 /**
  * A utility class that calculates the shortest path between two points on the battlescape map.
@@ -42,7 +78,14 @@ private:
 	constexpr static int dir_z[dir_max] = {  0,  0,  0,  0,  0,  0,  0,  0, +1, -1};
 
 	SavedBattleGame *_save;
-	std::vector<PathfindingNode> _nodes;
+	/// Search state of every tile: open at 2 * _searchId, checked at 2 * _searchId + 1, anything else is unvisited.
+	std::vector<Uint32> _nodeState;
+	std::vector<int> _nodeTUCost, _nodePrev;
+	std::vector<Sint8> _nodePrevDir;
+	Uint32 _searchId;
+	PathfindingOpenSet _openSet;
+	/// Directions blocked by walls from every tile, for each movement type. Bit 8 marks the entry as known.
+	std::vector<Uint16> _blockedDirections[MT_SINK + 1];
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
@@ -50,14 +93,24 @@ private:
 	int _totalTUCost;
 	bool _modifierUsed;
 	MovementType _movementType;
-	/// Gets the node at certain position.
-	PathfindingNode *getNode(Position pos);
+	/// Starts a new search, marking all nodes as unvisited.
+	void resetNodes();
+	/// Is the node in the open set of the current search?
+	bool isNodeOpen(int node) const { return _nodeState[node] == 2 * _searchId; }
+	/// Is the node already at its minimum cost in the current search?
+	bool isNodeChecked(int node) const { return _nodeState[node] == 2 * _searchId + 1; }
+	/// Connects a node to the previous node along the path.
+	void connectNode(int node, int tuCost, int prevNode, int prevDir);
 	/// Determines whether a tile blocks a certain movementType.
 	bool isBlocked(Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion = -1) const;
+	/// Determines whether a tile blocks a certain movementType of a given unit.
+	bool isBlocked(BattleUnit *movingUnit, MovementType movementType, Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion = -1) const;
 	/// Tries to find a straight line path between two positions.
 	bool bresenhamPath(Position origin, Position target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
 	/// Tries to find a path between two positions.
 	bool aStarPath(Position origin, Position target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
+	/// Determines whether movement between start tile and its neighbour is possible, using the terrain cache when it can.
+	bool isBlockedDirectionCached(Tile *startTile, const int direction, BattleUnit *missileTarget);
 	/// Determines whether a unit can fall down from this tile.
 	bool canFallDown(Tile *destinationTile) const;
 	/// Determines whether a unit can fall down from this tile.
@@ -66,6 +119,8 @@ private:
 public:
 	/// Determines whether the unit is going up a stairs.
 	bool isOnStairs(Position startPosition, Position endPosition) const;
+	/// Moves a destination to where a unit would actually stop.
+	bool adjustDestination(BattleUnit *unit, MovementType movementType, Position &endPosition, BattleUnit *missileTarget) const;
 	/// Determines whether or not movement between start tile and end tile is possible in the direction.
 	bool isBlockedDirection(Tile *startTile, const int direction, BattleUnit *missileTarget);
 	static const int DIR_UP = 8;
@@ -81,6 +136,10 @@ public:
 	~Pathfinding();
 	/// Calculates the shortest path.
 	void calculate(BattleUnit *unit, Position endPosition, BattleUnit *missileTarget = 0, int maxTUCost = 1000);
+	/// Calculates the cheapest paths from the unit to all tiles.
+	void calculateCostField(PathfindingCostField &field, BattleUnit *unit, int maxTUCost = 1000);
+	/// Forgets the cached terrain blockage around changed tiles.
+	void invalidateTerrainCache(Position position, int radius = 0);
 
 	/**
 	 * Converts direction to a vector. Direction starts north = 0 and goes clockwise.
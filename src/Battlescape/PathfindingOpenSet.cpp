@@ -17,73 +17,80 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
 #include "PathfindingOpenSet.h"
-#include "PathfindingNode.h"
 
 namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Initializes an empty set.
  */
-PathfindingOpenSet::~PathfindingOpenSet()
+PathfindingOpenSet::PathfindingOpenSet() : _first(0), _last(0), _count(0)
 {
-	while (!_queue.empty())
-	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
-	}
 }
 
 /**
- * Keeps removing all discarded entries that have come to the top of the queue.
+ * Gets a node with the least cost.
+ * After this call, the entry is no longer in the set. It is an error to call this when the set is empty.
+ * @param cost Gets the cost the node was pushed with.
+ * @return The index of the node.
  */
-void PathfindingOpenSet::removeDiscarded()
+int PathfindingOpenSet::pop(int &cost)
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	assert(!empty());
+	while (_buckets[_first].empty())
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		++_first;
 	}
+	std::vector<int> &bucket = _buckets[_first];
+	int node = bucket.back();
+	bucket.pop_back();
+	--_count;
+	cost = (int)_first;
+	return node;
 }
 
 /**
- * Gets the node with the least cost.
- * After this call, the node is no longer in the set. It is an error to call this when the set is empty.
- * @return A pointer to the node which had the least cost.
+ * Places the node in the set.
+ * If the node was already in the set, the previous entry stays and has to be skipped by the caller.
+ * @param node The index of the node to add.
+ * @param cost The cost to order the node by, must not be negative.
  */
-PathfindingNode *PathfindingOpenSet::pop()
+void PathfindingOpenSet::push(int node, int cost)
 {
-	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
-	return nd;
+	assert(cost >= 0);
+	size_t key = cost;
+	if (key >= _buckets.size())
+	{
+		_buckets.resize(key + 1);
+	}
+	if (_count == 0)
+	{
+		_first = _last = key;
+	}
+	else
+	{
+		_first = std::min(_first, key);
+		_last = std::max(_last, key);
+	}
+	_buckets[key].push_back(node);
+	++_count;
 }
 
 /**
- * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
- * It is the caller's responsibility to never re-add a node with a worse cost.
- * @param node A pointer to the node to add.
+ * Removes all entries, only touching the buckets that were used.
  */
-void PathfindingOpenSet::push(PathfindingNode *node)
+void PathfindingOpenSet::clear()
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	if (_count != 0)
+	{
+		for (size_t i = _first; i <= _last; ++i)
+		{
+			_buckets[i].clear();
+		}
+	}
+	_first = _last = _count = 0;
 }
 
-
 }
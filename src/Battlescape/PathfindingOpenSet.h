@@ -17,57 +17,34 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
+#include <cstddef>
+#include <vector>
 
 namespace OpenXcom
 {
 
-class PathfindingNode;
-
-struct OpenSetEntry
-{
-	int _cost;
-	PathfindingNode *_node;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
-	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
- * A class that holds references to the nodes to be examined in pathfinding.
+ * A class that holds the indices of the nodes to be examined in pathfinding,
+ * in buckets keyed on their integer TU cost.
+ * Nodes are never removed when they get a better cost; the caller pushes them
+ * again and skips the outdated entries when they are popped.
  */
 class PathfindingOpenSet
 {
+private:
+	std::vector<std::vector<int> > _buckets;
+	std::size_t _first, _last, _count;
 public:
-	/// Cleans up the set and frees allocated memory.
-	~PathfindingOpenSet();
+	/// Creates an empty set.
+	PathfindingOpenSet();
 	/// Gets the next node to check.
-	PathfindingNode *pop();
+	int pop(int &cost);
 	/// Adds a node to the set.
-	void push(PathfindingNode *node);
+	void push(int node, int cost);
+	/// Removes all nodes from the set, keeping the allocated memory.
+	void clear();
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
-
-private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
-
-	/// Removes reachable discarded entries.
-	void removeDiscarded();
+	bool empty() const { return _count == 0; }
 };
 
 }
@@ -16,7 +16,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <climits>
 #include <set>
 #include "TileEngine.h"
@@ -45,6 +47,8 @@
 #include "Pathfinding.h"
 #include "../Engine/Game.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/ThreadPool.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -54,6 +58,80 @@ namespace OpenXcom
 namespace
 {
 
+/**
+ * Single entry cache of voxelCheck, each thread has its own.
+ */
+struct VoxelCheckCache
+{
+	Uint32 generation = 0;
+	Position pos;
+	int index = 0;
+	Tile *tile = nullptr;
+	Tile *tileBelow = nullptr;
+};
+
+/// Voxel grid shape of tiles without any terrain.
+constexpr Uint16 VoxelShapeEmpty = 0;
+
+/// Voxel grid shape of tiles that need the full check of their parts.
+constexpr Uint16 VoxelShapeUnknown = 0xFFFF;
+
+/// Last generation used by voxelCheckFlush, older caches are stale.
+std::atomic<Uint32> voxelCheckCacheGeneration(0);
+
+thread_local VoxelCheckCache voxelCheckCache;
+
+/**
+ * Direction of one explosion ray.
+ */
+struct ExplosionRay
+{
+	int te;
+	double sinTe, cosTe, sinFi, cosFi;
+};
+
+/// Number of explosion rays traced on each vertical angle.
+constexpr int ExplosionRaysPerLevel = 121;
+
+/// Explosions with a smaller radius are not worth splitting between threads.
+constexpr int ExplosionParallelRadius = 6;
+
+/**
+ * Gets the directions of all rays traced by an explosion,
+ * every 3 degrees horizontally on every 5 degrees vertically,
+ * one vertical angle after another.
+ * @return Ray directions, calculated on first use.
+ */
+const std::vector<ExplosionRay> &getExplosionRays()
+{
+	static const std::vector<ExplosionRay> rays = []
+	{
+		std::vector<ExplosionRay> r;
+		for (int fi = -90; fi <= 90; fi += 5)
+		{
+			for (int te = 0; te <= 360; te += 3)
+			{
+				r.push_back({ te, sin(Deg2Rad(te)), cos(Deg2Rad(te)), sin(Deg2Rad(fi)), cos(Deg2Rad(fi)) });
+			}
+		}
+		return r;
+	}();
+	return rays;
+}
+
+/**
+ * Checks if a unit uses visibility scripts, these can look at
+ * visible units of others so can't be run in parallel.
+ * @param unit Unit to check.
+ * @return True if any script would run.
+ */
+bool hasVisibilityScript(const BattleUnit *unit)
+{
+	const auto &script = unit->getArmor()->getScript<ModScript::VisibilityUnit>();
+	const ScriptContainerBase *events = script.dataEvents();
+	return script.data() != nullptr || (events && (*events || *(events + 1)));
+}
+
 /**
  * Calculates a line trajectory, using bresenham algorithm in 3D.
  * @param origin Origin.
@@ -211,6 +289,48 @@ MapSubset mapAreaExpand(MapSubset gs, int radius)
 	return { std::make_pair(gs.beg_x - radius, gs.end_x + radius), std::make_pair(gs.beg_y - radius, gs.end_y + radius) };
 }
 
+/// Number of column bands given to each thread, more than one evens out bands with more work.
+constexpr int LightBandsPerThread = 4;
+
+/// Smaller areas (in map columns) are not worth splitting between threads.
+constexpr int LightParallelArea = 256;
+
+/**
+ * Splits some subset of the map into bands of columns along the x axis
+ * and calls back with each of them, on the shared thread pool if the area
+ * is big enough. The call back must only change tiles inside its band.
+ * @param save Map data.
+ * @param gs Square subset of map area.
+ * @param func Call back, gets subset of the band.
+ */
+template<typename BandFunc>
+void iterateBands(SavedBattleGame* save, MapSubset gs, BandFunc func)
+{
+	gs = MapSubset::intersection(gs, MapSubset{ save->getMapSizeX(), save->getMapSizeY() });
+	if (!gs)
+	{
+		return;
+	}
+
+	ThreadPool &pool = ThreadPool::getShared();
+	const int bands = std::min(gs.size_x(), pool.getThreadCount() * LightBandsPerThread);
+	if (pool.getThreadCount() == 1 || bands < 2 || gs.size_x() * gs.size_y() < LightParallelArea)
+	{
+		func(gs);
+		return;
+	}
+
+	pool.run(bands,
+		[&](size_t band, int thread)
+		{
+			MapSubset part = gs;
+			part.beg_x = gs.beg_x + gs.size_x() * (int)band / bands;
+			part.end_x = gs.beg_x + gs.size_x() * ((int)band + 1) / bands;
+			func(part);
+		}
+	);
+}
+
 } // namespace
 
 constexpr int TileEngine::heightFromCenter[11];
@@ -228,14 +348,25 @@ constexpr Position TileEngine::voxelTileCenter;
  * @param maxDarknessToSeeUnits Threshold of darkness for LoS calculation.
  */
 TileEngine::TileEngine(SavedBattleGame *save, Mod *mod) :
-	_save(save), _voxelData(mod->getVoxelData()), _inventorySlotGround(mod->getInventoryGround()), _personalLighting(true), _cacheTile(0), _cacheTileBelow(0),
+	_save(save), _voxelData(mod->getVoxelData()), _inventorySlotGround(mod->getInventoryGround()), _personalLighting(true), _cacheGeneration(0),
 	_maxViewDistance(mod->getMaxViewDistance()), _maxViewDistanceSq(_maxViewDistance * _maxViewDistance),
 	_maxVoxelViewDistance(_maxViewDistance * 16), _maxDarknessToSeeUnits(mod->getMaxDarknessToSeeUnits()),
 	_maxStaticLightDistance(mod->getMaxStaticLightDistance()), _maxDynamicLightDistance(mod->getMaxDynamicLightDistance()),
 	_enhancedLighting(mod->getEnhancedLighting())
 {
 	_blockVisibility.resize(save->getMapSizeXYZ());
-	_cacheTilePos = invalid;
+	_explosionStamp.resize(save->getMapSizeXYZ());
+	_explosionDamage.resize(save->getMapSizeXYZ());
+	if (Options::oxceVoxelGrid)
+	{
+		// filled in when lighting updates the terrain caches
+		_voxelGrid.assign(save->getMapSizeXYZ(), VoxelShapeUnknown);
+		_voxelShapes.push_back(VoxelShape{});
+		_voxelShapeLookup[{ }] = VoxelShapeEmpty;
+	}
+	voxelCheckFlush();
+	_fovDirtyBeg = invalid;
+	_fovDirtyEnd = invalid;
 }
 
 /**
@@ -253,30 +384,37 @@ void TileEngine::calculateSunShading(MapSubset gs)
 {
 	int power = 15 - _save->getGlobalShade();
 
-	iterateTiles(
+	iterateBands(
 		_save,
 		gs,
-		[&](Tile* tile)
+		[&](MapSubset band)
 		{
-			auto currLight = power;
-
-			// At night/dusk sun isn't dropping shades blocked by roofs
-			if (_save->getGlobalShade() <= 4)
-			{
-				int block = 0;
-				int x = tile->getPosition().x;
-				int y = tile->getPosition().y;
-				for (int z = _save->getMapSizeZ()-1; z > tile->getPosition().z ; z--)
-				{
-					block += blockage(_save->getTile(Position(x, y, z)), O_FLOOR, DT_NONE);
-					block += blockage(_save->getTile(Position(x, y, z)), O_OBJECT, DT_NONE, Pathfinding::DIR_DOWN);
-				}
-				if (block>0)
+			iterateTiles(
+				_save,
+				band,
+				[&](Tile* tile)
 				{
-					currLight -= 2;
+					auto currLight = power;
+
+					// At night/dusk sun isn't dropping shades blocked by roofs
+					if (_save->getGlobalShade() <= 4)
+					{
+						int block = 0;
+						int x = tile->getPosition().x;
+						int y = tile->getPosition().y;
+						for (int z = _save->getMapSizeZ()-1; z > tile->getPosition().z ; z--)
+						{
+							block += blockage(_save->getTile(Position(x, y, z)), O_FLOOR, DT_NONE);
+							block += blockage(_save->getTile(Position(x, y, z)), O_OBJECT, DT_NONE, Pathfinding::DIR_DOWN);
+						}
+						if (block>0)
+						{
+							currLight -= 2;
+						}
+					}
+					tile->addLight(currLight, LL_AMBIENT);
 				}
-			}
-			tile->addLight(currLight, LL_AMBIENT);
+			);
 		}
 	);
 }
@@ -289,6 +427,7 @@ void TileEngine::calculateTerrainBackground(MapSubset gs)
 	const int fireLightPower = 15; // amount of light a fire generates
 
 	// add lighting of fire
+	_lightSources.clear();
 	iterateTiles(
 		_save,
 		mapAreaExpand(gs, getMaxStaticLightDistance() - 1),
@@ -323,9 +462,13 @@ void TileEngine::calculateTerrainBackground(MapSubset gs)
 			{
 				currLight = getMaxStaticLightDistance() - 1;
 			}
-			addLight(gs, tile->getPosition(), currLight, LL_FIRE);
+			if (currLight > 0)
+			{
+				_lightSources.push_back({ tile->getPosition(), currLight });
+			}
 		}
 	);
+	addLights(gs, LL_FIRE);
 }
 
 /**
@@ -334,6 +477,7 @@ void TileEngine::calculateTerrainBackground(MapSubset gs)
 void TileEngine::calculateTerrainItems(MapSubset gs)
 {
 	// add lighting of terrain
+	_lightSources.clear();
 	iterateTiles(
 		_save,
 		mapAreaExpand(gs, getMaxDynamicLightDistance() - 1),
@@ -353,9 +497,13 @@ void TileEngine::calculateTerrainItems(MapSubset gs)
 			{
 				currLight = getMaxDynamicLightDistance() - 1;
 			}
-			addLight(gs, tile->getPosition(), currLight, LL_ITEMS);
+			if (currLight > 0)
+			{
+				_lightSources.push_back({ tile->getPosition(), currLight });
+			}
 		}
 	);
+	addLights(gs, LL_ITEMS);
 }
 
 /**
@@ -365,6 +513,7 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 {
 	const int fireLightPower = 15; // amount of light a fire generates
 
+	_lightSources.clear();
 	for (BattleUnit *unit : *_save->getUnits())
 	{
 		if (unit->isOut())
@@ -396,20 +545,54 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 		{
 			currLight = getMaxDynamicLightDistance() - 1;
 		}
+		if (currLight <= 0)
+		{
+			continue;
+		}
 		const auto size = unit->getArmor()->getSize();
 		const auto pos = unit->getPosition();
 		for (int x = 0; x < size; ++x)
 		{
 			for (int y = 0; y < size; ++y)
 			{
-				addLight(gs, pos + Position(x, y, 0), currLight, LL_UNITS);
+				_lightSources.push_back({ pos + Position(x, y, 0), currLight });
 			}
 		}
 	}
+	addLights(gs, LL_UNITS);
+}
+
+/**
+ * Adds light of all collected light sources of one layer. Every tile gets
+ * the light from the sources in the order they were collected, so the map
+ * can be split into bands that are lit in parallel.
+ * @param gs Subset of map to light.
+ * @param layer Layer of the light sources.
+ */
+void TileEngine::addLights(MapSubset gs, LightLayers layer)
+{
+	if (_lightSources.empty())
+	{
+		return;
+	}
+
+	iterateBands(
+		_save,
+		gs,
+		[&](MapSubset band)
+		{
+			for (const LightSource &source : _lightSources)
+			{
+				addLight(band, source.center, source.power, layer);
+			}
+		}
+	);
 }
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	Profiler::Scope profile(PROF_CALCULATE_LIGHTING);
+
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -421,62 +604,84 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 
 	if (terrianChanged)
 	{
-		iterateTiles(
+		iterateBands(
 			_save,
 			mapArea(position, position != invalid ? eventRadius + 1 : 1000),
-			[&](Tile* tile)
+			[&](MapSubset band)
 			{
-				const auto currPos = tile->getPosition();
-				const auto index = _save->getTileIndex(currPos);
-				const auto mapData = tile->getMapData(O_OBJECT);
-				auto &cache = _blockVisibility[index];
-
-				cache = {};
-				cache.height = -tile->getTerrainLevel();
-				if (mapData)
-				{
-					if (mapData->getTUCost(MT_WALK) == 255)
+				iterateTiles(
+					_save,
+					band,
+					[&](Tile* tile)
 					{
-						cache.height = 24;
-					}
-				}
-				cache.smoke = (tile->getSmoke() > 0);
-				cache.fire = (tile->getFire() > 0);
-				cache.blockUp = (verticalBlockage(tile, _save->getAboveTile(tile), DT_NONE) > 127);
-				cache.blockDown = (verticalBlockage(tile, _save->getBelowTile(tile), DT_NONE) > 127);
-				for (int dir = 0; dir < 8; ++dir)
-				{
-					Position pos = {};
-					Pathfinding::directionToVector(dir, &pos);
-					auto tileNext = _save->getTile(currPos + pos);
-					auto result = 0;
+						const auto currPos = tile->getPosition();
+						const auto index = _save->getTileIndex(currPos);
+						const auto mapData = tile->getMapData(O_OBJECT);
+						auto &cache = _blockVisibility[index];
+
+						cache = {};
+						cache.height = -tile->getTerrainLevel();
+						if (mapData)
+						{
+							if (mapData->getTUCost(MT_WALK) == 255)
+							{
+								cache.height = 24;
+							}
+						}
+						cache.smoke = (tile->getSmoke() > 0);
+						cache.fire = (tile->getFire() > 0);
+						cache.blockUp = (verticalBlockage(tile, _save->getAboveTile(tile), DT_NONE) > 127);
+						cache.blockDown = (verticalBlockage(tile, _save->getBelowTile(tile), DT_NONE) > 127);
+						for (int dir = 0; dir < 8; ++dir)
+						{
+							Position pos = {};
+							Pathfinding::directionToVector(dir, &pos);
+							auto tileNext = _save->getTile(currPos + pos);
+							auto result = 0;
 
-					result = horizontalBlockage(tile, tileNext, DT_NONE, true);
-					if (result == -1)
-					{
-						cache.bigWall |= (1 << dir);
-					}
+							result = horizontalBlockage(tile, tileNext, DT_NONE, true);
+							if (result == -1)
+							{
+								cache.bigWall |= (1 << dir);
+							}
 
-					result = horizontalBlockage(tile, tileNext, DT_NONE);
-					if (result > 127 || result == -1)
-					{
-						cache.blockDir |= (1 << dir);
-					}
+							result = horizontalBlockage(tile, tileNext, DT_NONE);
+							if (result > 127 || result == -1)
+							{
+								cache.blockDir |= (1 << dir);
+							}
 
-					tileNext = _save->getTile(currPos + pos + Position{ 0, 0, 1 });
-					if (verticalBlockage(tile, tileNext, DT_NONE) > 127)
-					{
-						cache.blockDirUp |= (1 << dir);
+							tileNext = _save->getTile(currPos + pos + Position{ 0, 0, 1 });
+							if (verticalBlockage(tile, tileNext, DT_NONE) > 127)
+							{
+								cache.blockDirUp |= (1 << dir);
+							}
+
+							tileNext = _save->getTile(currPos + pos + Position{ 0, 0, -1 });
+							if (verticalBlockage(tile, tileNext, DT_NONE) > 127)
+							{
+								cache.blockDirDown |= (1 << dir);
+							}
+						}
 					}
+				);
+			}
+		);
 
-					tileNext = _save->getTile(currPos + pos + Position{ 0, 0, -1 });
-					if (verticalBlockage(tile, tileNext, DT_NONE) > 127)
+		if (!_voxelGrid.empty())
+		{
+			iterateTiles(
+				_save,
+				mapArea(position, position != invalid ? eventRadius + 1 : 1000),
+				[&](Tile* tile)
+				{
+					if (tile->isTerrainChanged() || _voxelGrid[_save->getTileIndex(tile->getPosition())] == VoxelShapeUnknown)
 					{
-						cache.blockDirDown |= (1 << dir);
+						updateVoxelGrid(tile);
 					}
 				}
-			}
-		);
+			);
+		}
 	}
 
 	if (layer <= LL_FIRE)
@@ -681,17 +886,18 @@ void TileEngine::addLight(MapSubset gs, Position center, int power, LightLayers
  * the observer based on the event affecting visibility at the event itself and beyond it in its direction.
  * Imagines a circle around the event of eventRadius, calculates its tangents, and places points at the circle's tangent
  * intersections for later bounds checking.
+ * @param sector Sector to setup.
  * @param observerPos Position of the observer of this event.
  * @param eventPos The centre of the event. Ie a moving unit's position, centre of explosion, a single destroyed tile, etc.
  * @param eventRadius Radius big enough to fully envelop the event. Ie for a single tile change, set radius to 1.
  * @return true if area is unlimited.
  *
 */
-bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius)
+bool TileEngine::setupEventVisibilitySector(EventVisibilitySector &sector, const Position &observerPos, const Position &eventPos, const int &eventRadius)
 {
 	if (eventRadius == 0 || eventPos == Position(-1, -1, -1) || Position::distance2dSq(observerPos, eventPos) <= eventRadius * eventRadius)
 	{
-		_eventVisibilityObserverPos = Position{ -1, -1, -1 };
+		sector.observerPos = Position{ -1, -1, -1 };
 		return true;
 	}
 	else
@@ -705,11 +911,11 @@ bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const P
 		float t1 = b - a;
 		float t2 = b + a;
 		//Define the points where the lines tangent to the circle intersect it. Note: resulting positions are relative to observer, not in direct tile space.
-		_eventVisibilitySectorL.x = roundf(eventPos.x + eventRadius * sinf(t1)) - observerPos.x;
-		_eventVisibilitySectorL.y = roundf(eventPos.y - eventRadius * cosf(t1)) - observerPos.y;
-		_eventVisibilitySectorR.x = roundf(eventPos.x - eventRadius * sinf(t2)) - observerPos.x;
-		_eventVisibilitySectorR.y = roundf(eventPos.y + eventRadius * cosf(t2)) - observerPos.y;
-		_eventVisibilityObserverPos = observerPos;
+		sector.left.x = roundf(eventPos.x + eventRadius * sinf(t1)) - observerPos.x;
+		sector.left.y = roundf(eventPos.y - eventRadius * cosf(t1)) - observerPos.y;
+		sector.right.x = roundf(eventPos.x - eventRadius * sinf(t2)) - observerPos.x;
+		sector.right.y = roundf(eventPos.y + eventRadius * cosf(t2)) - observerPos.y;
+		sector.observerPos = observerPos;
 		return false;
 	}
 }
@@ -717,17 +923,18 @@ bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const P
 /**
  * Checks whether toCheck is within a previously setup eventVisibilitySector. See setupEventVisibilitySector(...).
  * May be used to rapidly reduce the search space when updating unit and tile visibility.
+ * @param sector The sector to check against.
  * @param toCheck The position to check.
  * @return true if within the circle sector.
  */
-inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
+inline bool TileEngine::inEventVisibilitySector(const EventVisibilitySector &sector, const Position &toCheck)
 {
-	if (_eventVisibilityObserverPos != Position{ -1, -1, -1 })
+	if (sector.observerPos != Position{ -1, -1, -1 })
 	{
-		Position posDiff = toCheck - _eventVisibilityObserverPos;
+		Position posDiff = toCheck - sector.observerPos;
 		//Is toCheck within the arc as defined by the two tangent points?
-		return (!(-_eventVisibilitySectorL.x * posDiff.y + _eventVisibilitySectorL.y * posDiff.x > 0) &&
-			(-_eventVisibilitySectorR.x * posDiff.y + _eventVisibilitySectorR.y * posDiff.x > 0));
+		return (!(-sector.left.x * posDiff.y + sector.left.y * posDiff.x > 0) &&
+			(-sector.right.x * posDiff.y + sector.right.y * posDiff.x > 0));
 	}
 	else
 	{
@@ -735,15 +942,87 @@ inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
 	}
 }
 
+/**
+ * Checks whether the line of sight from the observer to a tile could pass through the levels
+ * of the tiles marked dirty. The line is a straight one in tile space, so only the part of it
+ * between distanceMin and distanceMax from the observer (the horizontal extent of the dirty
+ * area) needs to be checked against the dirty levels.
+ * @param observerPos Position of the observer's eyes.
+ * @param toCheck The position to check.
+ * @param distanceMin Horizontal distance from the observer to the nearest dirty column.
+ * @param distanceMax Horizontal distance from the observer to the farthest dirty column.
+ * @return true if visibility of the position could have been changed.
+ */
+inline bool TileEngine::inEventVisibilityLevels(const Position &observerPos, const Position &toCheck, float distanceMin, float distanceMax) const
+{
+	const float distance = sqrtf(Position::distance2dSq(observerPos, toCheck));
+	if (distance < distanceMin)
+	{
+		//The line ends before it reaches the dirty area.
+		return false;
+	}
+	if (distance == 0.0f)
+	{
+		return true;
+	}
+	const int diffZ = toCheck.z - observerPos.z;
+	float levelNear = observerPos.z + diffZ * (distanceMin / distance);
+	float levelFar = observerPos.z + diffZ * std::min(distanceMax / distance, 1.0f);
+	if (levelNear > levelFar)
+	{
+		std::swap(levelNear, levelFar);
+	}
+	//One level of slack for rounding of the tile line and for floors blocking it from below.
+	return levelFar + 1.0f >= _fovDirtyBeg.z && levelNear - 1.0f <= _fovDirtyEnd.z;
+}
+
+/**
+ * Checks whether an event could be in the view sector of a unit at all. The event is
+ * approximated by the square enclosing its circle; when any corner of it is in the view
+ * sector, the unit may see some part of the event.
+ * @param unit Observer of the event.
+ * @param eventPos The centre of the event.
+ * @param eventRadius Radius big enough to fully envelop the event.
+ * @param useTurretDirection Use the turret direction for the view sector.
+ * @return true if the unit could see the event.
+ */
+bool TileEngine::inEventViewSector(BattleUnit *unit, const Position &eventPos, int eventRadius, bool useTurretDirection) const
+{
+	if (eventRadius <= 0 || eventPos == invalid)
+	{
+		return true;
+	}
+	//Close to the event the view sector could pass between the corners, only trust the test further away.
+	const int range = eventRadius + unit->getArmor()->getSize();
+	if (Position::distance2dSq(unit->getPosition(), eventPos) <= 4 * range * range)
+	{
+		return true;
+	}
+	for (int x = -1; x <= 1; ++x)
+	{
+		for (int y = -1; y <= 1; ++y)
+		{
+			if (unit->checkViewSector(eventPos + Position(x * eventRadius, y * eventRadius, 0), useTurretDirection))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 /**
 * Updates line of sight of a single soldier in a narrow arc around a given event position.
 * @param unit Unit to check line of sight of.
 * @param eventPos The centre of the event which necessitated the FOV update. Used to optimize which tiles to update.
 * @param eventRadius The radius of a circle able to fully encompass the event, in tiles. Hence: 1 for a single tile event.
+* @param buffer If set, changes of other units and tiles are stored there instead of applied.
 * @return True when new aliens are spotted.
 */
-bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
+bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius, VisibilityBuffer *buffer)
 {
+	Profiler::Scope profile(PROF_CALCULATE_FOV);
+
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	bool useTurretDirection = false;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
@@ -754,7 +1033,8 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 		return false;
 
 	Position posSelf = unit->getPosition();
-	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius))
+	EventVisibilitySector sector;
+	if (setupEventVisibilitySector(sector, posSelf, eventPos, eventRadius))
 	{
 		//Asked to do a full check. Or the event is overlapping our tile. Better check everything.
 		unit->clearVisibleUnits();
@@ -773,7 +1053,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 				{
 					Position posToCheck = posOther + Position(x, y, 0);
 					//If we can now find any unit within the arc defined by the event tangent points, its visibility may have been affected by the event.
-					if (inEventVisibilitySector(posToCheck))
+					if (inEventVisibilitySector(sector, posToCheck))
 					{
 						if (!unit->checkViewSector(posToCheck, useTurretDirection))
 						{
@@ -783,23 +1063,25 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 						else if (visible(unit, _save->getTile(posToCheck))) // (distance is checked here)
 						{
 							//Unit (or part thereof) visible to one or more eyes of this unit.
-							if (unit->getFaction() == FACTION_PLAYER)
+							if (unit->getFaction() == FACTION_PLAYER && !buffer)
 							{
 								(*i)->setVisible(true);
 							}
+							bool added = false;
 							if ((( (*i)->getFaction() == FACTION_HOSTILE && unit->getFaction() == FACTION_PLAYER )
 								|| ( (*i)->getFaction() != FACTION_HOSTILE && unit->getFaction() == FACTION_HOSTILE ))
 								&& !unit->hasVisibleUnit((*i)))
 							{
 								unit->addToVisibleUnits((*i));
-								unit->addToVisibleTiles((*i)->getTile());
-
-								if (unit->getFaction() == FACTION_HOSTILE && (*i)->getFaction() != FACTION_HOSTILE)
-								{
-									(*i)->setTurnsSinceSpotted(0);
-
-									(*i)->setTurnsLeftSpottedForSnipers(std::max(unit->getSpotterDuration(), (*i)->getTurnsLeftSpottedForSnipers())); // defaults to 0 = no information given to snipers
-								}
+								added = true;
+							}
+							if (buffer)
+							{
+								buffer->units.push_back(std::make_pair((*i), added));
+							}
+							else if (added)
+							{
+								spotUnit(unit, (*i));
 							}
 
 							x = y = sizeOther; //If a unit's tile is visible there's no need to check the others: break the loops.
@@ -831,9 +1113,13 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 * @param unit Unit to check line of sight of.
 * @param eventPos The centre of the event which necessitated the FOV update. Used to optimize which tiles to update.
 * @param eventRadius The radius of a circle able to fully encompass the event, in tiles. Hence: 1 for a single tile event.
+* @param appendToTileVisibility true to keep the tiles seen before and only add the new ones.
+* @param buffer If set, newly seen tiles are stored there instead of applied. Tiles of the unit need to be cleared before.
 */
-void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius)
+void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius, const bool appendToTileVisibility, VisibilityBuffer *buffer)
 {
+	Profiler::Scope profile(PROF_CALCULATE_FOV);
+
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
@@ -845,21 +1131,30 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 	{
 		direction = unit->getDirection();
 	}
-	if (unit->getFaction() != FACTION_PLAYER || (eventRadius == 1 && !unit->checkViewSector(eventPos, useTurretDirection)))
+	if (unit->getFaction() != FACTION_PLAYER || (eventRadius == 1 && !unit->checkViewSector(eventPos, useTurretDirection)) || !inEventViewSector(unit, eventPos, eventRadius, useTurretDirection))
 	{
 		//The event wasn't meant for us and/or visible for us.
 		return;
 	}
 	else if (unit->isOut())
 	{
-		unit->clearVisibleTiles();
+		if (!buffer)
+		{
+			unit->clearVisibleTiles();
+		}
 		return;
 	}
 	Position posSelf = unit->getPosition();
-	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius))
+	EventVisibilitySector sector;
+	//When only appending, the tiles that could be hidden by the event are cleared further down.
+	const bool appendOnly = appendToTileVisibility && eventPos != invalid && !buffer;
+	if (setupEventVisibilitySector(sector, posSelf, eventPos, eventRadius))
 	{
 		//Asked to do a full check. Or unit within event. Should update all.
-		unit->clearVisibleTiles();
+		if (!buffer && !appendOnly)
+		{
+			unit->clearVisibleTiles();
+		}
 		skipNarrowArcTest = true;
 	}
 
@@ -882,6 +1177,34 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 			++posSelf.z;
 		}
 	}
+
+	//When appending, only lines of sight passing through the tiles that changed need to be traced again.
+	const bool useDirtyLevels = appendToTileVisibility && eventPos != invalid && _fovDirtyBeg != invalid;
+	float dirtyDistanceMin = 0.0f;
+	float dirtyDistanceMax = 0.0f;
+	if (useDirtyLevels)
+	{
+		const int nearX = Clamp<int>(posSelf.x, _fovDirtyBeg.x, _fovDirtyEnd.x) - posSelf.x;
+		const int nearY = Clamp<int>(posSelf.y, _fovDirtyBeg.y, _fovDirtyEnd.y) - posSelf.y;
+		const int farX = std::max(std::abs(_fovDirtyBeg.x - posSelf.x), std::abs(_fovDirtyEnd.x - posSelf.x));
+		const int farY = std::max(std::abs(_fovDirtyBeg.y - posSelf.y), std::abs(_fovDirtyEnd.y - posSelf.y));
+		const int size = unit->getArmor()->getSize();
+		dirtyDistanceMin = std::max(sqrtf(nearX * nearX + nearY * nearY) - size, 0.0f);
+		dirtyDistanceMax = sqrtf(farX * farX + farY * farY) + size;
+	}
+	if (skipNarrowArcTest && appendOnly)
+	{
+		//The event can hide tiles too (smoke, closed doors, units), so drop the tiles traced again below,
+		//the ones still in sight are added back. Lines to any other tile don't pass through the event.
+		if (useDirtyLevels)
+		{
+			unit->clearVisibleTiles([&](Tile *tile) { return inEventVisibilityLevels(posSelf, tile->getPosition(), dirtyDistanceMin, dirtyDistanceMax); });
+		}
+		else
+		{
+			unit->clearVisibleTiles();
+		}
+	}
 	//Test all tiles within view cone for visibility.
 	for (int x = 0; x <= getMaxViewDistance(); ++x) //TODO: Possible improvement: find the intercept points of the arc at max view distance and choose a more intelligent sweep of values when an event arc is defined.
 	{
@@ -903,12 +1226,17 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 				posTest.x = posSelf.x + signX[direction] * (swap ? y : x);
 				posTest.y = posSelf.y + signY[direction] * (swap ? x : y);
 				//Only continue if the column of tiles at (x,y) is within the narrow arc of interest (if enabled)
-				if (inEventVisibilitySector(posTest))
+				if (inEventVisibilitySector(sector, posTest))
 				{
 					for (int z = 0; z < _save->getMapSizeZ(); z++)
 					{
 						posTest.z = z;
 
+						if (useDirtyLevels && !inEventVisibilityLevels(posSelf, posTest, dirtyDistanceMin, dirtyDistanceMax))
+						{
+							continue;
+						}
+
 						if (_save->getTile(posTest)) //inside map?
 						{
 							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
@@ -929,20 +1257,19 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 									//Reveal all tiles along line of vision. Note: needed due to width of bresenham stroke.
 									for (std::vector<Position>::iterator i = _trajectory.begin(); i != _trajectory.end(); ++i)
 									{
-										Position posVisited = (*i);
+										Tile *tileVisited = _save->getTile(*i);
 										//Add tiles to the visible list only once. BUT we still need to calculate the whole trajectory as
 										// this bresenham line's period might be different from the one that originally revealed the tile.
-										if (!unit->hasVisibleTile(_save->getTile(posVisited)))
+										if (buffer)
 										{
-											unit->addToVisibleTiles(_save->getTile(posVisited));
-											_save->getTile(posVisited)->setVisible(+1);
-											_save->getTile(posVisited)->setDiscovered(true, O_FLOOR);
-
-											// walls to the east or south of a visible tile, we see that too
-											Tile* t = _save->getTile(Position(posVisited.x + 1, posVisited.y, posVisited.z));
-											if (t) t->setDiscovered(true, O_WESTWALL);
-											t = _save->getTile(Position(posVisited.x, posVisited.y + 1, posVisited.z));
-											if (t) t->setDiscovered(true, O_NORTHWALL);
+											if (buffer->tilesLookup.insert(tileVisited).second)
+											{
+												buffer->tiles.push_back(tileVisited);
+											}
+										}
+										else if (!unit->hasVisibleTile(tileVisited))
+										{
+											revealTile(unit, tileVisited);
 										}
 									}
 								}
@@ -955,6 +1282,67 @@ void TileEngine::calculateTilesInFOV(BattleUnit *unit, const Position eventPos,
 	}
 }
 
+/**
+ * Adds a tile to the tiles seen by a unit and discovers it.
+ * @param unit Unit seeing the tile.
+ * @param tile Tile that is seen.
+ */
+void TileEngine::revealTile(BattleUnit *unit, Tile *tile)
+{
+	const Position pos = tile->getPosition();
+	unit->addToVisibleTiles(tile);
+	tile->setVisible(+1);
+	tile->setDiscovered(true, O_FLOOR);
+
+	// walls to the east or south of a visible tile, we see that too
+	Tile* t = _save->getTile(Position(pos.x + 1, pos.y, pos.z));
+	if (t) t->setDiscovered(true, O_WESTWALL);
+	t = _save->getTile(Position(pos.x, pos.y + 1, pos.z));
+	if (t) t->setDiscovered(true, O_NORTHWALL);
+}
+
+/**
+ * Updates the units and tiles after a unit newly spotted another one.
+ * @param unit Unit that spotted.
+ * @param spotted Unit that was spotted.
+ */
+void TileEngine::spotUnit(BattleUnit *unit, BattleUnit *spotted)
+{
+	unit->addToVisibleTiles(spotted->getTile());
+
+	if (unit->getFaction() == FACTION_HOSTILE && spotted->getFaction() != FACTION_HOSTILE)
+	{
+		spotted->setTurnsSinceSpotted(0);
+
+		spotted->setTurnsLeftSpottedForSnipers(std::max(unit->getSpotterDuration(), spotted->getTurnsLeftSpottedForSnipers())); // defaults to 0 = no information given to snipers
+	}
+}
+
+/**
+ * Applies visibility of a unit calculated into a buffer, in the same order
+ * calculateTilesInFOV and calculateUnitsInFOV would have applied it.
+ * @param unit Unit the buffer was calculated for.
+ * @param buffer Calculated visibility.
+ */
+void TileEngine::applyVisibilityBuffer(BattleUnit *unit, const VisibilityBuffer &buffer)
+{
+	for (std::vector<Tile*>::const_iterator i = buffer.tiles.begin(); i != buffer.tiles.end(); ++i)
+	{
+		revealTile(unit, *i);
+	}
+	for (std::vector<std::pair<BattleUnit*, bool> >::const_iterator i = buffer.units.begin(); i != buffer.units.end(); ++i)
+	{
+		if (unit->getFaction() == FACTION_PLAYER)
+		{
+			i->first->setVisible(true);
+		}
+		if (i->second)
+		{
+			spotUnit(unit, i->first);
+		}
+	}
+}
+
 /**
 * Recalculates line of sight of a soldier.
 * @param unit Unit to check line of sight of.
@@ -1437,8 +1825,9 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 
 	int unitRadius = potentialUnit->getLoftemps(); //width == loft in default loftemps set
 	int targetSize = potentialUnit->getArmor()->getSize() - 1;
-	int xOffset = potentialUnit->getPosition().x - tile->getPosition().x;
-	int yOffset = potentialUnit->getPosition().y - tile->getPosition().y;
+	// a hypothetical unit stands on the tile, not where the real one is
+	int xOffset = hypothetical ? 0 : potentialUnit->getPosition().x - tile->getPosition().x;
+	int yOffset = hypothetical ? 0 : potentialUnit->getPosition().y - tile->getPosition().y;
 	if (targetSize > 0)
 	{
 		unitRadius = 3;
@@ -1691,6 +2080,8 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	Profiler::Scope profile(PROF_CALCULATE_FOV);
+
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -1713,12 +2104,37 @@ void TileEngine::calculateFOV(Position position, int eventRadius, const bool upd
 				{
 					(*i)->clearVisibleTiles();
 				}
-				calculateTilesInFOV((*i), position, eventRadius);
+				calculateTilesInFOV((*i), position, eventRadius, appendToTileVisibility);
 			}
 
 			calculateUnitsInFOV((*i), position, eventRadius);
 		}
 	}
+	_fovDirtyBeg = invalid;
+	_fovDirtyEnd = invalid;
+}
+
+/**
+ * Marks tiles that changed in a way that can affect line of sight. The next
+ * calculateFOV(Position, ...) call appending to tile visibility then only
+ * traces lines of sight that can pass through the marked tiles.
+ * @param position Position of the changed tile.
+ * @param radius Horizontal radius of the change around the position.
+ */
+void TileEngine::markFOVDirty(Position position, int radius)
+{
+	const Position beg = position - Position(radius, radius, 0);
+	const Position end = position + Position(radius, radius, 0);
+	if (_fovDirtyBeg == invalid)
+	{
+		_fovDirtyBeg = beg;
+		_fovDirtyEnd = end;
+	}
+	else
+	{
+		_fovDirtyBeg = Position(std::min(_fovDirtyBeg.x, beg.x), std::min(_fovDirtyBeg.y, beg.y), std::min(_fovDirtyBeg.z, beg.z));
+		_fovDirtyEnd = Position(std::max(_fovDirtyEnd.x, end.x), std::max(_fovDirtyEnd.y, end.y), std::max(_fovDirtyEnd.z, end.z));
+	}
 }
 
 /**
@@ -2508,6 +2924,12 @@ void TileEngine::hit(BattleActionAttack attack, Position center, int power, cons
 			layer = LL_FIRE; // spawned fire or smoke that can block light.
 		}
 		calculateLighting(layer, tilePos, 1, true);
+		if (terrainChanged)
+		{
+			markFOVDirty(tilePos);
+			_save->getPathfinding()->invalidateTerrainCache(tilePos);
+			_save->getExposureMap()->invalidate();
+		}
 		calculateFOV(tilePos, 1, true, terrainChanged); //append any new units or tiles revealed by the terrain change
 	}
 	else
@@ -2537,10 +2959,7 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 	const Position centetTile = center.toTile();
 	int hitSide = 0;
 	int diagonalWall = 0;
-	int power_;
-	std::map<Tile*, int> tilesAffected;
 	std::vector<BattleItem*> toRemove;
-	std::pair<std::map<Tile*, int>::iterator, bool> ret;
 
 	if (type->FireBlastCalc)
 	{
@@ -2563,7 +2982,6 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 	}
 
 	Tile *origin = _save->getTile(Position(centetTile));
-	Tile *dest = nullptr;
 	if (origin->isBigWall()) //pre-calculations for bigwall deflection
 	{
 		diagonalWall = origin->getMapData(O_OBJECT)->getBigWall();
@@ -2573,152 +2991,212 @@ void TileEngine::explode(BattleActionAttack attack, Position center, int power,
 			hitSide = (center.x % 16 + center.y % 16 - 15) > 0 ? 1 : -1;
 	}
 
-	for (int fi = -90; fi <= 90; fi += 5)
+	// a ray leaves the map after at most this many steps
+	const int mapDiagonal = (int)sqrt((double)_save->getMapSizeX() * _save->getMapSizeX() + _save->getMapSizeY() * _save->getMapSizeY() + _save->getMapSizeZ() * _save->getMapSizeZ()) + 2;
+	const int stepsPerRay = std::max(0, std::min(maxRadius, mapDiagonal) + 1);
+	const std::vector<ExplosionRay> &rays = getExplosionRays();
+	_explosionSteps.resize(rays.size() * stepsPerRay);
+	_explosionRayLength.resize(rays.size());
+
+	// tracing only looks at the terrain, which doesn't change until the tiles detonate at the end
+	auto traceRay = [&](size_t r)
 	{
-		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
-		for (int te = 0; te <= 360; te += 3)
+		const ExplosionRay &ray = rays[r];
+		ExplosionStep *steps = &_explosionSteps[r * stepsPerRay];
+		int count = 0;
+		Tile *from = nullptr;
+		Tile *dest = _save->getTile(centetTile);
+		double l = 0;
+		int tileX, tileY, tileZ;
+		int power_ = power;
+		while (power_ > 0 && l <= maxRadius && count < stepsPerRay)
 		{
-			double cos_te = cos(Deg2Rad(te));
-			double sin_te = sin(Deg2Rad(te));
-			double sin_fi = sin(Deg2Rad(fi));
-			double cos_fi = cos(Deg2Rad(fi));
+			steps[count].tileIndex = _save->getTileIndex(dest->getPosition());
+			steps[count].power = power_;
+			++count;
+
+			l += 1.0;
+
+			tileX = int(floor(centetTile.x + 0.5 + l * ray.sinTe * ray.cosFi));
+			tileY = int(floor(centetTile.y + 0.5 + l * ray.cosTe * ray.cosFi));
+			tileZ = int(floor(centetTile.z + 0.5 + l * ray.sinFi));
+
+			from = dest;
+			dest = _save->getTile(Position(tileX, tileY, tileZ));
+
+			if (!dest) break; // out of map!
 
-			origin = _save->getTile(centetTile);
-			dest = origin;
-			double l = 0;
-			int tileX, tileY, tileZ;
-			power_ = power;
-			while (power_ > 0 && l <= maxRadius)
+			// blockage by terrain is deducted from the explosion power
+			power_ -= type->RadiusReduction; // explosive damage decreases by 10 per tile
+			if (from->getPosition().z != tileZ)
+				power_ -= vertdec; //3d explosion factor
+
+			if (type->FireBlastCalc)
 			{
-				if (power_ > 0)
+				int dir;
+				Pathfinding::vectorToDirection(from->getPosition() - dest->getPosition(), dir);
+				if (dir != -1 && dir %2) power_ -= 0.5f * type->RadiusReduction; // diagonal movement costs an extra 50% for fire.
+			}
+			if (l > 0.5) {
+				if ( l > 1.5)
 				{
-					ret = tilesAffected.insert(std::make_pair(dest, 0)); // check if we had this tile already affected
-
-					const int tileDmg = type->getTileFinalDamage(power_);
-					if (tileDmg > ret.first->second)
+					power_ -= verticalBlockage(from, dest, type->ResistType, false) * 2;
+					power_ -= horizontalBlockage(from, dest, type->ResistType, false) * 2;
+				}
+				else //tricky bigwall deflection /Volutar
+				{
+					const int te = ray.te;
+					bool skipObject = diagonalWall == 0;
+					if (diagonalWall == Pathfinding::BIGWALLNESW) // --
 					{
-						ret.first->second = tileDmg;
+						if (hitSide<0 && te >= 135 && te < 315)
+							skipObject = true;
+						if (hitSide>0 && ( te < 135 || te > 315))
+							skipObject = true;
 					}
-					if (ret.second)
+					if (diagonalWall == Pathfinding::BIGWALLNWSE) // |
 					{
-						const int damage = type->getRandomDamage(power_);
-						BattleUnit *bu = dest->getOverlappingUnit(_save);
-
-						toRemove.clear();
-						if (bu)
-						{
-							if (Position::distance2d(dest->getPosition(), centetTile) < 2)
-							{
-								// ground zero effect is in effect
-								hitUnit(attack, bu, Position(0, 0, 0), damage, type, rangeAtack);
-							}
-							else
-							{
-								// directional damage relative to explosion position.
-								// units above the explosion will be hit in the legs, units lateral to or below will be hit in the torso
-								hitUnit(attack, bu, centetTile + Position(0, 0, 5) - dest->getPosition(), damage, type, rangeAtack);
-							}
-
-							// Affect all items and units in inventory
-							const int itemDamage = bu->getOverKillDamage();
-							if (itemDamage > 0)
-							{
-								for (std::vector<BattleItem*>::iterator it = bu->getInventory()->begin(); it != bu->getInventory()->end(); ++it)
-								{
-									if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), itemDamage, type, rangeAtack) && type->getItemFinalDamage(itemDamage) > (*it)->getRules()->getArmor())
-									{
-										toRemove.push_back(*it);
-									}
-								}
-							}
-						}
-						// Affect all items and units on ground
-						for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
-						{
-							if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), damage, type) && type->getItemFinalDamage(damage) > (*it)->getRules()->getArmor())
-							{
-								toRemove.push_back(*it);
-							}
-						}
-						for (std::vector<BattleItem*>::iterator it = toRemove.begin(); it != toRemove.end(); ++it)
-						{
-							_save->removeItem((*it));
-						}
-
-						hitTile(dest, damage, type);
+						if (hitSide>0 && te >= 45 && te < 225)
+							skipObject = true;
+						if (hitSide<0 && ( te < 45 || te > 225))
+							skipObject = true;
 					}
-				}
-
-				l += 1.0;
+					power_ -= verticalBlockage(from, dest, type->ResistType, skipObject) * 2;
+					power_ -= horizontalBlockage(from, dest, type->ResistType, skipObject) * 2;
 
-				tileX = int(floor(centetTile.x + 0.5 + l * sin_te * cos_fi));
-				tileY = int(floor(centetTile.y + 0.5 + l * cos_te * cos_fi));
-				tileZ = int(floor(centetTile.z + 0.5 + l * sin_fi));
+				}
+			}
+		}
+		_explosionRayLength[r] = count;
+	};
 
-				origin = dest;
-				dest = _save->getTile(Position(tileX, tileY, tileZ));
+	ThreadPool &pool = ThreadPool::getShared();
+	if (pool.getThreadCount() > 1 && maxRadius >= ExplosionParallelRadius)
+	{
+		// bundles of rays with the same vertical angle
+		pool.run(rays.size() / ExplosionRaysPerLevel,
+			[&](size_t level, int thread)
+			{
+				for (size_t r = level * ExplosionRaysPerLevel; r < (level + 1) * ExplosionRaysPerLevel; ++r)
+				{
+					traceRay(r);
+				}
+			}
+		);
+	}
+	else
+	{
+		for (size_t r = 0; r < rays.size(); ++r)
+		{
+			traceRay(r);
+		}
+	}
 
-				if (!dest) break; // out of map!
+	// apply the damage in the order the rays reach the tiles, as if traced one after another
+	if (++_explosionGeneration == 0)
+	{
+		std::fill(_explosionStamp.begin(), _explosionStamp.end(), 0);
+		_explosionGeneration = 1;
+	}
+	_explosionTiles.clear();
+	for (size_t r = 0; r < rays.size(); ++r)
+	{
+		const ExplosionStep *steps = &_explosionSteps[r * stepsPerRay];
+		for (int s = 0; s < _explosionRayLength[r]; ++s)
+		{
+			const int index = steps[s].tileIndex;
+			const int power_ = steps[s].power;
+			const bool firstHit = _explosionStamp[index] != _explosionGeneration; // check if we had this tile already affected
+			if (firstHit)
+			{
+				_explosionStamp[index] = _explosionGeneration;
+				_explosionDamage[index] = 0;
+				_explosionTiles.push_back(index);
+			}
 
-				// blockage by terrain is deducted from the explosion power
-				power_ -= type->RadiusReduction; // explosive damage decreases by 10 per tile
-				if (origin->getPosition().z != tileZ)
-					power_ -= vertdec; //3d explosion factor
+			const int tileDmg = type->getTileFinalDamage(power_);
+			if (tileDmg > _explosionDamage[index])
+			{
+				_explosionDamage[index] = tileDmg;
+			}
+			if (firstHit)
+			{
+				Tile *dest = _save->getTile(index);
+				const int damage = type->getRandomDamage(power_);
+				BattleUnit *bu = dest->getOverlappingUnit(_save);
 
-				if (type->FireBlastCalc)
+				toRemove.clear();
+				if (bu)
 				{
-					int dir;
-					Pathfinding::vectorToDirection(origin->getPosition() - dest->getPosition(), dir);
-					if (dir != -1 && dir %2) power_ -= 0.5f * type->RadiusReduction; // diagonal movement costs an extra 50% for fire.
-				}
-				if (l > 0.5) {
-					if ( l > 1.5)
+					if (Position::distance2d(dest->getPosition(), centetTile) < 2)
 					{
-						power_ -= verticalBlockage(origin, dest, type->ResistType, false) * 2;
-						power_ -= horizontalBlockage(origin, dest, type->ResistType, false) * 2;
+						// ground zero effect is in effect
+						hitUnit(attack, bu, Position(0, 0, 0), damage, type, rangeAtack);
 					}
-					else //tricky bigwall deflection /Volutar
+					else
 					{
-						bool skipObject = diagonalWall == 0;
-						if (diagonalWall == Pathfinding::BIGWALLNESW) // --
-						{
-							if (hitSide<0 && te >= 135 && te < 315)
-								skipObject = true;
-							if (hitSide>0 && ( te < 135 || te > 315))
-								skipObject = true;
-						}
-						if (diagonalWall == Pathfinding::BIGWALLNWSE) // |
+						// directional damage relative to explosion position.
+						// units above the explosion will be hit in the legs, units lateral to or below will be hit in the torso
+						hitUnit(attack, bu, centetTile + Position(0, 0, 5) - dest->getPosition(), damage, type, rangeAtack);
+					}
+
+					// Affect all items and units in inventory
+					const int itemDamage = bu->getOverKillDamage();
+					if (itemDamage > 0)
+					{
+						for (std::vector<BattleItem*>::iterator it = bu->getInventory()->begin(); it != bu->getInventory()->end(); ++it)
 						{
-							if (hitSide>0 && te >= 45 && te < 225)
-								skipObject = true;
-							if (hitSide<0 && ( te < 45 || te > 225))
-								skipObject = true;
+							if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), itemDamage, type, rangeAtack) && type->getItemFinalDamage(itemDamage) > (*it)->getRules()->getArmor())
+							{
+								toRemove.push_back(*it);
+							}
 						}
-						power_ -= verticalBlockage(origin, dest, type->ResistType, skipObject) * 2;
-						power_ -= horizontalBlockage(origin, dest, type->ResistType, skipObject) * 2;
-
 					}
 				}
+				// Affect all items and units on ground
+				for (std::vector<BattleItem*>::iterator it = dest->getInventory()->begin(); it != dest->getInventory()->end(); ++it)
+				{
+					if (!hitUnit(attack, (*it)->getUnit(), Position(0, 0, 0), damage, type) && type->getItemFinalDamage(damage) > (*it)->getRules()->getArmor())
+					{
+						toRemove.push_back(*it);
+					}
+				}
+				for (std::vector<BattleItem*>::iterator it = toRemove.begin(); it != toRemove.end(); ++it)
+				{
+					_save->removeItem((*it));
+				}
+
+				hitTile(dest, damage, type);
 			}
 		}
 	}
+	// tiles are stored in one array, so this is the same order as sorting by address
+	std::sort(_explosionTiles.begin(), _explosionTiles.end());
 
 	// now detonate the tiles affected by explosion
 	if (type->ToTile > 0.0f)
 	{
-		for (std::map<Tile*, int>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		for (int index : _explosionTiles)
 		{
-			if (detonate(i->first, i->second))
+			Tile *tile = _save->getTile(index);
+			if (detonate(tile, _explosionDamage[index]))
 			{
 				_save->addDestroyedObjective();
 			}
-			applyGravity(i->first);
-			Tile *j = _save->getTile(i->first->getPosition() + Position(0,0,1));
+			applyGravity(tile);
+			Tile *j = _save->getTile(tile->getPosition() + Position(0,0,1));
 			if (j)
 				applyGravity(j);
 		}
 	}
 	calculateLighting(LL_AMBIENT, centetTile, maxRadius + 1, true); // roofs could have been destroyed and fires could have been started
+	for (int index : _explosionTiles)
+	{
+		Position pos = _save->getTile(index)->getPosition();
+		markFOVDirty(pos); // terrain, smoke or fire of these tiles could have changed
+		_save->getPathfinding()->invalidateTerrainCache(pos);
+		_save->getExposureMap()->invalidate();
+	}
 	calculateFOV(centetTile, maxRadius + 1, true, true);
 	if (attack.attacker && Position::distance2d(centetTile, attack.attacker->getPosition()) > maxRadius + 1)
 	{
@@ -3362,12 +3840,16 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 						{
 							++doorsOpened;
 							doorCentre = unit->getPosition() + Position(x, y, z) + i->first;
+							_save->getPathfinding()->invalidateTerrainCache(doorCentre);
+							_save->getExposureMap()->invalidate();
 						}
 						else if (door == 1)
 						{
 							std::pair<int, Position> adjacentDoors = checkAdjacentDoors(unit->getPosition() + Position(x,y,z) + i->first, i->second);
 							doorsOpened += adjacentDoors.first + 1;
 							doorCentre = adjacentDoors.second;
+							_save->getPathfinding()->invalidateTerrainCache(doorCentre, doorsOpened);
+							_save->getExposureMap()->invalidate();
 						}
 					}
 				}
@@ -3399,6 +3881,7 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 			{
 				calculateLighting(LL_FIRE, doorCentre, doorsOpened, true);
 				// Update FOV through the doorway.
+				markFOVDirty(doorCentre, doorsOpened);
 				calculateFOV(doorCentre, doorsOpened, true, true);
 			}
 			else return 4;
@@ -3479,7 +3962,12 @@ int TileEngine::closeUfoDoors()
 				continue;
 			}
 		}
-		doorsclosed += _save->getTile(i)->closeUfoDoor();
+		if (_save->getTile(i)->closeUfoDoor())
+		{
+			_save->getPathfinding()->invalidateTerrainCache(_save->getTileCoords(i));
+			_save->getExposureMap()->invalidate();
+			++doorsclosed;
+		}
 	}
 
 	return doorsclosed;
@@ -3764,10 +4252,11 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	}
 	Position pos = voxel.toTile();
 	Tile *tile, *tileBelow;
-	if (_cacheTilePos == pos)
+	VoxelCheckCache &cache = voxelCheckCache;
+	if (cache.generation == _cacheGeneration && cache.pos == pos)
 	{
-		tile = _cacheTile;
-		tileBelow = _cacheTileBelow;
+		tile = cache.tile;
+		tileBelow = cache.tileBelow;
 	}
 	else
 	{
@@ -3777,9 +4266,11 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 			return V_OUTOFBOUNDS; //not even cache
 		}
 		tileBelow = _save->getBelowTile(tile);
-		_cacheTilePos = pos;
-		_cacheTile = tile;
-		_cacheTileBelow = tileBelow;
+		cache.generation = _cacheGeneration;
+		cache.pos = pos;
+		cache.index = _save->getTileIndex(pos);
+		cache.tile = tile;
+		cache.tileBelow = tileBelow;
  	}
 
 	if (tile->isVoid() && tile->getUnit() == 0 && (!tileBelow || tileBelow->getUnit() == 0))
@@ -3795,8 +4286,23 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 		}
 	}
 
+	// the voxel grid can tell that no part was hit, on a hit the loop below finds which one
+	bool checkParts = true;
+	if (!_voxelGrid.empty() && !tile->isTerrainChanged())
+	{
+		const Uint16 shape = _voxelGrid[cache.index];
+		if (shape == VoxelShapeEmpty)
+		{
+			checkParts = false;
+		}
+		else if (shape != VoxelShapeUnknown)
+		{
+			checkParts = _voxelShapes[shape].rows[((voxel.z%24)/2)*16 + voxel.y%16] & (1 << (15 - voxel.x%16));
+		}
+	}
+
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	for (int i = V_FLOOR; checkParts && i <= V_OBJECT; ++i)
 	{
 		TilePart tp = (TilePart)i;
 		MapData *mp = tile->getMapData(tp);
@@ -3856,11 +4362,70 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	return V_EMPTY;
 }
 
+/**
+ * Flushes the voxel check cache of all threads.
+ */
 void TileEngine::voxelCheckFlush()
 {
-	_cacheTilePos = invalid;
-	_cacheTile = 0;
-	_cacheTileBelow = 0;
+	_cacheGeneration = ++voxelCheckCacheGeneration;
+}
+
+/**
+ * Merges the voxels of the tile parts the same way voxelCheck looks at them
+ * and stores the result in the voxel grid. Tiles with the same parts share
+ * one shape. Grav lift floors have special rules and always get the full check.
+ * @param tile Tile to update.
+ */
+void TileEngine::updateVoxelGrid(Tile *tile)
+{
+	Uint16 &shape = _voxelGrid[_save->getTileIndex(tile->getPosition())];
+	tile->clearTerrainChanged();
+
+	if (tile->getMapData(O_FLOOR) && tile->getMapData(O_FLOOR)->isGravLift())
+	{
+		shape = VoxelShapeUnknown;
+		return;
+	}
+
+	std::array<MapData*, 4> parts = { };
+	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	{
+		TilePart tp = (TilePart)i;
+		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+			continue;
+		parts[i] = tile->getMapData(tp);
+	}
+
+	auto it = _voxelShapeLookup.find(parts);
+	if (it != _voxelShapeLookup.end())
+	{
+		shape = it->second;
+		return;
+	}
+	if (_voxelShapes.size() >= VoxelShapeUnknown)
+	{
+		shape = VoxelShapeUnknown;
+		return;
+	}
+
+	VoxelShape merged = { };
+	for (MapData *mp : parts)
+	{
+		if (mp != 0)
+		{
+			for (int layer = 0; layer < 12; ++layer)
+			{
+				int idx = mp->getLoftID(layer) * 16;
+				for (int y = 0; y < 16; ++y)
+				{
+					merged.rows[layer * 16 + y] |= _voxelData->at(idx + y);
+				}
+			}
+		}
+	}
+	shape = (Uint16)_voxelShapes.size();
+	_voxelShapes.push_back(merged);
+	_voxelShapeLookup[parts] = shape;
 }
 
 /**
@@ -4787,14 +5352,73 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
 
 /**
  * Recalculates FOV of all units in-game.
+ * With more than one thread, the visibility of each unit is calculated into
+ * a buffer on the worker threads and applied afterwards in unit order, so the
+ * result is the same as when calculated one unit after another.
  */
 void TileEngine::recalculateFOV()
 {
-	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
+	Profiler::Scope profile(PROF_CALCULATE_FOV);
+
+	std::vector<BattleUnit*> &units = *_save->getUnits();
+	ThreadPool &pool = ThreadPool::getShared();
+	if (pool.getThreadCount() == 1 || units.size() < 2)
+	{
+		for (std::vector<BattleUnit*>::iterator bu = units.begin(); bu != units.end(); ++bu)
+		{
+			if ((*bu)->getTile() != 0)
+			{
+				calculateFOV(*bu);
+			}
+		}
+		return;
+	}
+
+	// visibility scripts can look at units updated before, these need to be done in order.
+	bool parallelUnits = true;
+	for (std::vector<BattleUnit*>::iterator bu = units.begin(); bu != units.end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
 		{
-			calculateFOV(*bu);
+			if (hasVisibilityScript(*bu))
+			{
+				parallelUnits = false;
+			}
+			if ((*bu)->getFaction() == FACTION_PLAYER)
+			{
+				(*bu)->clearVisibleTiles();
+			}
+		}
+	}
+
+	_visibilityBuffers.resize(units.size());
+	pool.run(units.size(),
+		[&](size_t i, int thread)
+		{
+			VisibilityBuffer &buffer = _visibilityBuffers[i];
+			buffer.tiles.clear();
+			buffer.tilesLookup.clear();
+			buffer.units.clear();
+			if (units[i]->getTile() != 0)
+			{
+				calculateTilesInFOV(units[i], invalid, 0, false, &buffer);
+				if (parallelUnits)
+				{
+					calculateUnitsInFOV(units[i], invalid, 0, &buffer);
+				}
+			}
+		}
+	);
+
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		if (units[i]->getTile() != 0)
+		{
+			applyVisibilityBuffer(units[i], _visibilityBuffers[i]);
+			if (!parallelUnits)
+			{
+				calculateUnitsInFOV(units[i]);
+			}
 		}
 	}
 }
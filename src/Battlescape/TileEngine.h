@@ -17,7 +17,10 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <array>
+#include <map>
 #include <vector>
+#include <unordered_set>
 #include "Position.h"
 #include "BattlescapeGame.h"
 #include "../Mod/RuleItem.h"
@@ -79,6 +82,47 @@ private:
 		Uint8 smoke: 1;
 		Uint8 fire: 1;
 	};
+	/**
+	 * Helper class storing the narrow circle sector around an event, as seen by one observer.
+	 */
+	struct EventVisibilitySector
+	{
+		Position left, right, observerPos;
+	};
+	/**
+	 * Helper class storing visibility of one unit calculated on a worker thread,
+	 * applied to tiles and units afterwards in the same order the serial update would do it.
+	 */
+	struct VisibilityBuffer
+	{
+		std::vector<Tile*> tiles;
+		std::unordered_set<Tile*> tilesLookup;
+		std::vector<std::pair<BattleUnit*, bool> > units;
+	};
+	/**
+	 * Helper class storing terrain voxels of one combination of tile parts,
+	 * with all parts merged into one row of bits for each voxel layer and y.
+	 */
+	struct VoxelShape
+	{
+		Uint16 rows[12 * 16];
+	};
+	/**
+	 * Helper class storing one light source of a layer.
+	 */
+	struct LightSource
+	{
+		Position center;
+		int power;
+	};
+	/**
+	 * Helper class storing one step of an explosion ray: the tile reached and the power left there.
+	 */
+	struct ExplosionStep
+	{
+		int tileIndex;
+		int power;
+	};
 	/**
 	 * Helper class storing reaction data.
 	 */
@@ -97,9 +141,7 @@ private:
 	RuleInventory *_inventorySlotGround;
 	constexpr static int heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 	bool _personalLighting;
-	Tile *_cacheTile;
-	Tile *_cacheTileBelow;
-	Position _cacheTilePos;
+	Uint32 _cacheGeneration;
 	const int _maxViewDistance;        // 20 tiles by default
 	const int _maxViewDistanceSq;      // 20 * 20
 	const int _maxVoxelViewDistance;   // maxViewDistance * 16
@@ -107,12 +149,27 @@ private:
 	const int _maxStaticLightDistance;
 	const int _maxDynamicLightDistance;
 	const int _enhancedLighting;
-	Position _eventVisibilitySectorL, _eventVisibilitySectorR, _eventVisibilityObserverPos;
+	Position _fovDirtyBeg, _fovDirtyEnd;
+	std::vector<VisibilityBuffer> _visibilityBuffers;
 	std::vector<BattleUnit*> _movingUnitPrev;
 	BattleUnit* _movingUnit = nullptr;
+	Uint32 _explosionGeneration = 0;
+	std::vector<ExplosionStep> _explosionSteps;
+	std::vector<int> _explosionRayLength;
+	std::vector<Uint32> _explosionStamp;
+	std::vector<int> _explosionDamage;
+	std::vector<int> _explosionTiles;
+	std::vector<LightSource> _lightSources;
+	std::vector<Uint16> _voxelGrid;
+	std::vector<VoxelShape> _voxelShapes;
+	std::map<std::array<MapData*, 4>, Uint16> _voxelShapeLookup;
 
 	/// Add light source.
 	void addLight(MapSubset gs, Position center, int power, LightLayers layer);
+	/// Add light of all collected light sources.
+	void addLights(MapSubset gs, LightLayers layer);
+	/// Updates the terrain voxel shape of a tile in the voxel grid.
+	void updateVoxelGrid(Tile *tile);
 	/// Calculate blockage amount.
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	/// Get max distance that fire light can reach.
@@ -130,8 +187,22 @@ private:
 	/// Get threshold of darkness for LoS calculation.
 	int getMaxDarknessToSeeUnits() const { return _maxDarknessToSeeUnits; }
 
-	bool setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius);
-	inline bool inEventVisibilitySector(const Position &toCheck) const;
+	static bool setupEventVisibilitySector(EventVisibilitySector &sector, const Position &observerPos, const Position &eventPos, const int &eventRadius);
+	static inline bool inEventVisibilitySector(const EventVisibilitySector &sector, const Position &toCheck);
+	/// Checks if line of sight to a tile could cross the levels changed by the current event.
+	inline bool inEventVisibilityLevels(const Position &observerPos, const Position &toCheck, float distanceMin, float distanceMax) const;
+	/// Checks if an event could be seen by the unit at all.
+	bool inEventViewSector(BattleUnit *unit, const Position &eventPos, int eventRadius, bool useTurretDirection) const;
+	/// Marks a tile as seen by a unit.
+	void revealTile(BattleUnit *unit, Tile *tile);
+	/// Updates units and tiles after a unit spotted another one.
+	void spotUnit(BattleUnit *unit, BattleUnit *spotted);
+	/// Applies visibility calculated on a worker thread.
+	void applyVisibilityBuffer(BattleUnit *unit, const VisibilityBuffer &buffer);
+	/// Calculates visible tiles of a unit, either directly or into a buffer.
+	void calculateTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius, const bool appendToTileVisibility, VisibilityBuffer *buffer);
+	/// Calculates visible units of a unit, either directly or into a buffer.
+	bool calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius, VisibilityBuffer *buffer);
 
 	/// Calculates sun shading of the whole map.
 	void calculateSunShading(MapSubset gs);
@@ -156,13 +227,21 @@ public:
 	/// Cleans up the TileEngine.
 	~TileEngine();
 	/// Calculates visible tiles within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
-	void calculateTilesInFOV(BattleUnit *unit, const Position eventPos = invalid, const int eventRadius = 0);
+	void calculateTilesInFOV(BattleUnit *unit, const Position eventPos = invalid, const int eventRadius = 0, const bool appendToTileVisibility = false)
+	{
+		calculateTilesInFOV(unit, eventPos, eventRadius, appendToTileVisibility, nullptr);
+	}
 	/// Calculates visible units within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
-	bool calculateUnitsInFOV(BattleUnit* unit, const Position eventPos = invalid, const int eventRadius = 0);
+	bool calculateUnitsInFOV(BattleUnit* unit, const Position eventPos = invalid, const int eventRadius = 0)
+	{
+		return calculateUnitsInFOV(unit, eventPos, eventRadius, nullptr);
+	}
 	/// Calculates the field of view from a units view point.
 	bool calculateFOV(BattleUnit *unit, bool doTileRecalc = true, bool doUnitRecalc = true);
 	/// Calculates the field of view within range of a certain position.
 	void calculateFOV(Position position, int eventRadius = -1, const bool updateTiles = true, const bool appendToTileVisibility = false);
+	/// Marks tiles that changed since the last field of view update.
+	void markFOVDirty(Position position, int radius = 0);
 	/// Checks reaction fire.
 	bool checkReactionFire(BattleUnit *unit, const BattleAction &originalAction);
 	/// Recalculate all lighting in some area.
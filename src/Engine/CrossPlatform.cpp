@@ -880,6 +880,33 @@ time_t getDateModified(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size of a file.
+ * @param path Full path to file.
+ * @return The size in bytes, 0 if the file is missing.
+ */
+Uint64 getFileSize(const std::string &path)
+{
+#ifdef _WIN32
+	auto pathW = pathToWindows(path);
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExW(pathW.c_str(), GetFileExInfoStandard, &data)) {
+		return 0;
+	}
+	return ((Uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0)
+	{
+		return info.st_size;
+	}
+	else
+	{
+		return 0;
+	}
+#endif
+}
+
 /**
  * Converts a date/time into a human-readable string
  * using the ISO 8601 standard.
@@ -1010,12 +1037,13 @@ bool writeFile(const std::string& filename, const std::vector<unsigned char>& da
 }
 
 /**
- * Gets an istream to a file
- * @param filename - what to readFile
- * @return the istream
+ * Reads a whole file into memory.
+ * @param filename - what to read
+ * @param mode - SDL_RWFromFile mode, "r" or "rb"
+ * @return the file contents
  */
-std::unique_ptr<std::istream> readFile(const std::string& filename) {
-	SDL_RWops *rwops = SDL_RWFromFile(filename.c_str(), "r");
+static std::string loadFile(const std::string& filename, const char *mode) {
+	SDL_RWops *rwops = SDL_RWFromFile(filename.c_str(), mode);
 	if (!rwops) {
 		std::string err = "Failed to read " + filename + ": " + SDL_GetError();
 		Log(LOG_ERROR) << err;
@@ -1030,11 +1058,29 @@ std::unique_ptr<std::istream> readFile(const std::string& filename) {
 	}
 	std::string datastr(data, size);
 	SDL_free(data);
-	return std::unique_ptr<std::istream>(new std::istringstream(datastr));
+	return datastr;
+}
+
+/**
+ * Gets an istream to a file
+ * @param filename - what to readFile
+ * @return the istream
+ */
+std::unique_ptr<std::istream> readFile(const std::string& filename) {
+	return std::unique_ptr<std::istream>(new std::istringstream(loadFile(filename, "r")));
+}
+
+/**
+ * Reads a whole file as is, without any newline translation.
+ * @param filename - what to read
+ * @return the file contents
+ */
+std::string readFileRaw(const std::string& filename) {
+	return loadFile(filename, "rb");
 }
 
 /**
- * Gets an istream to a file's bytes at least up to and including first "\n---" sequence.
+ * Gets an istream to a file's bytes up to and including first "\n---" sequence.
  * To be used only for savegames.
  * @param filename - what to read
  * @return the istream
@@ -1055,6 +1101,7 @@ std::unique_ptr<std::istream> getYamlSaveHeader(const std::string& filename) {
 		Log(LOG_ERROR) << err;
 		throw Exception(err);
 	}
+	data[0] = 0;
 	while(true) {
 		auto actually_read = SDL_RWread(rwops, data + offs, 1, chunksize);
 		if (actually_read == 0 || actually_read == -1) {
@@ -1075,6 +1122,11 @@ std::unique_ptr<std::istream> getYamlSaveHeader(const std::string& filename) {
 		data = newdata;
 		offs = size;
 	}
+	// cut off anything after the header, binary saves have no YAML there
+	const char *end = strstr(data, "\n---");
+	if (end != NULL) {
+		size = end - data + 4;
+	}
 	std::string datastr(data, size);
 	SDL_free(data);
 	SDL_RWclose(rwops);
@@ -96,7 +96,7 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	SDL_SetCursor(SDL_CreateCursor(&cursor, &cursor, 1,1,0,0));
 
 	// Create fps counter
-	_fpsCounter = new FpsCounter(15, 5, 0, 0);
+	_fpsCounter = new FpsCounter(32, 11, 0, 0);
 
 	// Create blank language
 	_lang = new Language();
@@ -182,10 +182,14 @@ void Game::run()
 				case SDL_QUIT:
 					quit();
 					break;
+				case SDL_VIDEOEXPOSE:
+					_screen->invalidate();
+					break;
 				case SDL_ACTIVEEVENT:
 					// An event other than SDL_APPMOUSEFOCUS change happened.
 					if (reinterpret_cast<SDL_ActiveEvent*>(&_event)->state & ~SDL_APPMOUSEFOCUS)
 					{
+						_screen->invalidate();
 						Uint8 currentState = SDL_GetAppState();
 						// Game is minimized
 						if (!(currentState & SDL_APPACTIVE))
@@ -341,6 +345,7 @@ void Game::run()
 				_fpsCounter->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
 				_screen->flip();
+				_fpsCounter->addPixels(_screen->getFlippedPixels());
 			}
 		}
 
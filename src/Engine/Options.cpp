@@ -230,6 +230,14 @@ void create()
 	_info.push_back(OptionInfo("oxceEnableSlackingIndicator", &oxceEnableSlackingIndicator, true));
 	_info.push_back(OptionInfo("oxceEnablePaletteFlickerFix", &oxceEnablePaletteFlickerFix, false));
 	_info.push_back(OptionInfo("oxcePersonalLayoutIncludingArmor", &oxcePersonalLayoutIncludingArmor, true));
+	_info.push_back(OptionInfo("oxceThreads", &oxceThreads, 0)); // 0 = number of cores
+	_info.push_back(OptionInfo("oxceBinarySaves", &oxceBinarySaves, false));
+	_info.push_back(OptionInfo("oxceVerifyBaseCapacities", &oxceVerifyBaseCapacities, false));
+	_info.push_back(OptionInfo("oxceGeoFastForward", &oxceGeoFastForward, false));
+	_info.push_back(OptionInfo("oxceVoxelGrid", &oxceVoxelGrid, false));
+	_info.push_back(OptionInfo("oxceAIExposureMap", &oxceAIExposureMap, true));
+	_info.push_back(OptionInfo("oxceScriptComputedGoto", &oxceScriptComputedGoto, true));
+	_info.push_back(OptionInfo("oxceScriptCheckDispatch", &oxceScriptCheckDispatch, false));
 
 	// OXCE hidden but moddable
 	_info.push_back(OptionInfo("oxceStartUpTextMode", &oxceStartUpTextMode, 0, "", "HIDDEN"));
@@ -79,6 +79,14 @@ OPT bool oxceEnableUnitResponseSounds;
 OPT bool oxceEnableSlackingIndicator;
 OPT bool oxceEnablePaletteFlickerFix;
 OPT bool oxcePersonalLayoutIncludingArmor;
+OPT int oxceThreads;
+OPT bool oxceBinarySaves;
+OPT bool oxceVerifyBaseCapacities;
+OPT bool oxceGeoFastForward;
+OPT bool oxceVoxelGrid;
+OPT bool oxceAIExposureMap;
+OPT bool oxceScriptComputedGoto;
+OPT bool oxceScriptCheckDispatch;
 
 // OXCE hidden, but moddable via fixedUserOptions and/or recommendedUserOptions
 OPT int oxceStartUpTextMode;
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+
+namespace OpenXcom
+{
+namespace Profiler
+{
+
+bool enabled = false;
+std::thread::id mainThread;
+
+namespace
+{
+
+Counter counters[PROF_MAX] = { };
+
+const char *names[PROF_MAX] =
+{
+	"calculateFOV",
+	"Pathfinding::calculate",
+	"Pathfinding::findReachable",
+	"Pathfinding::calculateCostField",
+	"calculateLighting",
+	"AIModule::think",
+	"time5Seconds",
+	"time10Minutes",
+	"time30Minutes",
+	"time1Hour",
+	"time1Day",
+	"time1Month",
+	"determineAlienMissions",
+};
+
+}
+
+/**
+ * Clears time and call count of all sections.
+ */
+void reset()
+{
+	mainThread = std::this_thread::get_id();
+	for (auto& c : counters)
+	{
+		c.time = std::chrono::steady_clock::duration::zero();
+		c.calls = 0;
+	}
+}
+
+/**
+ * Gets the accumulated data of a section.
+ * @param section Section to get.
+ * @return Counter of the section.
+ */
+Counter &getCounter(ProfilerSection section)
+{
+	return counters[section];
+}
+
+/**
+ * Gets the name used when reporting a section.
+ * @param section Section to get.
+ * @return Name of the section.
+ */
+const char *getName(ProfilerSection section)
+{
+	return names[section];
+}
+
+/**
+ * Gets total time spent in a section since the last reset.
+ * @param section Section to get.
+ * @return Time in milliseconds.
+ */
+double getMilliseconds(ProfilerSection section)
+{
+	return std::chrono::duration<double, std::milli>(counters[section].time).count();
+}
+
+}
+}
@@ -0,0 +1,113 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <thread>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Code sections that can be timed by the profiler.
+ */
+enum ProfilerSection : int
+{
+	PROF_CALCULATE_FOV,
+	PROF_PATHFINDING_CALCULATE,
+	PROF_PATHFINDING_REACHABLE,
+	PROF_PATHFINDING_COST_FIELD,
+	PROF_CALCULATE_LIGHTING,
+	PROF_AI_THINK,
+	PROF_GEO_TIME_5SEC,
+	PROF_GEO_TIME_10MIN,
+	PROF_GEO_TIME_30MIN,
+	PROF_GEO_TIME_1HOUR,
+	PROF_GEO_TIME_1DAY,
+	PROF_GEO_TIME_1MONTH,
+	PROF_GEO_ALIEN_MISSIONS,
+
+	PROF_MAX
+};
+
+/**
+ * Lightweight accumulating timer for hot code paths,
+ * used by the benchmark harnesses to report where time was spent.
+ * Does nothing (beside one branch) until enabled.
+ */
+namespace Profiler
+{
+	/// Accumulated data of one section.
+	struct Counter
+	{
+		std::chrono::steady_clock::duration time;
+		uint64_t calls;
+		int depth;
+	};
+
+	/// Is the profiler collecting data?
+	extern bool enabled;
+	/// Thread that is timed, work done on other threads counts to the section that started it.
+	extern std::thread::id mainThread;
+
+	/// Clears all counters and sets the calling thread as the timed one.
+	void reset();
+	/// Gets the counter of a section.
+	Counter &getCounter(ProfilerSection section);
+	/// Gets the display name of a section.
+	const char *getName(ProfilerSection section);
+	/// Gets total time spent in a section, in milliseconds.
+	double getMilliseconds(ProfilerSection section);
+
+	/**
+	 * Times the enclosing scope and adds it to a section.
+	 * Recursive or nested calls to the same section are counted only once.
+	 */
+	class Scope
+	{
+		Counter *_counter;
+		std::chrono::steady_clock::time_point _start;
+	public:
+		/// Starts timing if the profiler is enabled.
+		Scope(ProfilerSection section) : _counter(nullptr)
+		{
+			if (enabled && std::this_thread::get_id() == mainThread)
+			{
+				_counter = &getCounter(section);
+				if (_counter->depth++ == 0)
+				{
+					_counter->calls++;
+					_start = std::chrono::steady_clock::now();
+				}
+			}
+		}
+		/// Adds elapsed time to the section.
+		~Scope()
+		{
+			if (_counter && --_counter->depth == 0)
+			{
+				_counter->time += std::chrono::steady_clock::now() - _start;
+			}
+		}
+		Scope(const Scope&) = delete;
+		Scope &operator=(const Scope&) = delete;
+	};
+}
+
+}
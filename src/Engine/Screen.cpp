@@ -49,6 +49,9 @@ static const char* SDL_VIDEO_CENTERED_UNSET = "SDL_VIDEO_CENTERED=";
 static const char* SDL_VIDEO_CENTERED_CENTER = "SDL_VIDEO_CENTERED=center";
 static const char* SDL_VIDEO_WINDOW_POS_UNSET = "SDL_VIDEO_WINDOW_POS=";
 
+/// Rows around a damaged row that the filter kernels read to scale it.
+static const int SCALER_KERNEL_ROWS = 2;
+
 /**
  * Sets up all the internal display flags depending on
  * the current video settings.
@@ -112,7 +115,7 @@ void Screen::makeVideoFlags()
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _flickerFix(false)
+Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _paletteChanged(false), _flickerFix(false), _fullFlip(true), _flippedPixels(0)
 {
 	_flickerFix = Options::oxceEnablePaletteFlickerFix;
 
@@ -184,12 +187,41 @@ void Screen::handle(Action *action)
 /**
  * Renders the buffer's contents onto the screen, applying
  * any necessary filters or conversions in the process.
- * If the scaling factor is bigger than 1, the entire contents
+ * If the scaling factor is bigger than 1, the contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
  * before being put on screen.
+ * Only the rows that changed since the last flip are processed
+ * and updated, unless the display needs whole frames.
  */
 void Screen::flip()
 {
+	// a new palette or a page flipped display needs the whole frame
+	if (_paletteChanged || (_screen->flags & SDL_DOUBLEBUF) || useOpenGL())
+	{
+		_fullFlip = true;
+	}
+	int yFirst = 0, yLast = _baseHeight;
+	if (!findDamage(yFirst, yLast))
+	{
+		_flippedPixels = 0;
+		return;
+	}
+	bool fullFlip = _fullFlip;
+	if (fullFlip)
+	{
+		yFirst = 0;
+		yLast = _baseHeight;
+		Surface::CleanSdlSurface(_screen);
+	}
+	else
+	{
+		yFirst = std::max(0, yFirst - SCALER_KERNEL_ROWS);
+		yLast = std::min(_baseHeight, yLast + SCALER_KERNEL_ROWS);
+	}
+	_fullFlip = false;
+	_paletteChanged = false;
+	_flippedPixels = _baseWidth * (yLast - yFirst);
+
 	// perform any requested palette update
 	if (_flickerFix && _pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
 	{
@@ -203,11 +235,12 @@ void Screen::flip()
 
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
-		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
+		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput, yFirst, yLast);
 	}
 	else
 	{
-		SDL_BlitSurface(_surface.get(), 0, _screen, 0);
+		SDL_Rect rect = {0, (Sint16)yFirst, (Uint16)_baseWidth, (Uint16)(yLast - yFirst)};
+		SDL_BlitSurface(_surface.get(), &rect, _screen, &rect);
 	}
 
 	// perform any requested palette update
@@ -223,19 +256,85 @@ void Screen::flip()
 
 
 
-	if (SDL_Flip(_screen) == -1)
+	if (fullFlip)
+	{
+		if (SDL_Flip(_screen) == -1)
+		{
+			throw Exception(SDL_GetError());
+		}
+	}
+	else
 	{
-		throw Exception(SDL_GetError());
+		int dstFirst = yFirst, dstLast = yLast;
+		if (getHeight() != _baseHeight)
+		{
+			Zoom::getZoomedRows(_baseHeight, getHeight() - _topBlackBand - _bottomBlackBand, dstFirst, dstLast);
+			dstFirst += _topBlackBand;
+			dstLast += _topBlackBand;
+		}
+		SDL_UpdateRect(_screen, 0, dstFirst, getWidth(), dstLast - dstFirst);
 	}
 }
 
+/**
+ * Compares the buffer with its copy from the last flip
+ * to find the damaged rows, and updates the copy.
+ * @param yFirst Returns the first damaged row.
+ * @param yLast Returns the row past the last damaged one.
+ * @return True if there is anything to redraw.
+ */
+bool Screen::findDamage(int &yFirst, int &yLast)
+{
+	const size_t rowBytes = (size_t)_surface->w * _surface->format->BytesPerPixel;
+	const Uint8 *pixels = (const Uint8 *)_surface->pixels;
+	if (_lastFrame.size() != rowBytes * _surface->h)
+	{
+		_lastFrame.resize(rowBytes * _surface->h);
+		_fullFlip = true;
+	}
+
+	yFirst = _surface->h;
+	yLast = 0;
+	for (int y = 0; y < _surface->h; ++y)
+	{
+		const Uint8 *row = pixels + (size_t)y * _surface->pitch;
+		Uint8 *last = &_lastFrame[rowBytes * y];
+		if (memcmp(row, last, rowBytes) != 0)
+		{
+			memcpy(last, row, rowBytes);
+			yFirst = std::min(yFirst, y);
+			yLast = y + 1;
+		}
+	}
+	return _fullFlip || yFirst < yLast;
+}
+
 /**
  * Clears all the contents out of the internal buffer.
+ * The display itself is cleared on the next full flip.
  */
 void Screen::clear()
 {
 	Surface::CleanSdlSurface(_surface.get());
-	Surface::CleanSdlSurface(_screen);
+}
+
+/**
+ * Forces the next flip to redraw the whole display,
+ * eg. after the window was exposed.
+ */
+void Screen::invalidate()
+{
+	_fullFlip = true;
+}
+
+/**
+ * Returns the number of pixels of the internal buffer
+ * passed to the scalers by the last flip.
+ * @return Amount of pixels, 0 if nothing changed.
+ */
+int Screen::getFlippedPixels() const
+{
+	return _flippedPixels;
 }
 
 /**
@@ -263,6 +362,8 @@ void Screen::setPalette(const SDL_Color* colors, int firstcolor, int ncolors, bo
 	}
 
 	SDL_SetColors(_surface.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
+	// same pixels get new colors, the rows compare can't see that
+	_paletteChanged = true;
 
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, const_cast<SDL_Color *>(colors), firstcolor, ncolors) == 0)
@@ -394,6 +495,7 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 	Options::displayHeight = getHeight();
 	_scaleX = getWidth() / (double)_baseWidth;
 	_scaleY = getHeight() / (double)_baseHeight;
+	_fullFlip = true;
 
 	double pixelRatioY = 1.0;
 	if (Options::nonSquarePixelRatio && !Options::allowResize)
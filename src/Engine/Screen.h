@@ -19,6 +19,7 @@
  */
 #include <SDL.h>
 #include <string>
+#include <vector>
 #include "OpenGL.h"
 #include "Surface.h"
 
@@ -48,10 +49,16 @@ private:
 	SDL_Color deferredPalette[256];
 	int _numColors, _firstColor;
 	bool _pushPalette;
+	bool _paletteChanged;
 	bool _flickerFix;
 	OpenGL glOutput;
 	Surface::UniqueBufferPtr _buffer;
 	Surface::UniqueSurfacePtr _surface;
+	std::vector<Uint8> _lastFrame;
+	bool _fullFlip;
+	int _flippedPixels;
+	/// Finds the rows of the buffer that changed since the last flip.
+	bool findDamage(int &yFirst, int &yLast);
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
 public:
@@ -74,6 +81,10 @@ public:
 	void flip();
 	/// Clears the screen.
 	void clear();
+	/// Marks the whole screen to be redrawn on the next flip.
+	void invalidate();
+	/// Gets the number of buffer pixels processed by the last flip.
+	int getFlippedPixels() const;
 	/// Sets the screen's 8bpp palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256, bool immediately = false);
 	/// Gets the screen's 8bpp palette.
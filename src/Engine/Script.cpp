@@ -64,6 +64,22 @@ namespace OpenXcom
 	MACRO_COPY_64(Func, (Pos) + 0x80) \
 	MACRO_COPY_64(Func, (Pos) + 0xC0)
 
+// Same as above but every position is single token, that can be used to create names.
+#define MACRO_COPY_TOKEN_16(Func, High) \
+	Func(High##0) Func(High##1) Func(High##2) Func(High##3) \
+	Func(High##4) Func(High##5) Func(High##6) Func(High##7) \
+	Func(High##8) Func(High##9) Func(High##A) Func(High##B) \
+	Func(High##C) Func(High##D) Func(High##E) Func(High##F)
+#define MACRO_COPY_TOKEN_256(Func) \
+	MACRO_COPY_TOKEN_16(Func, 0x0) MACRO_COPY_TOKEN_16(Func, 0x1) \
+	MACRO_COPY_TOKEN_16(Func, 0x2) MACRO_COPY_TOKEN_16(Func, 0x3) \
+	MACRO_COPY_TOKEN_16(Func, 0x4) MACRO_COPY_TOKEN_16(Func, 0x5) \
+	MACRO_COPY_TOKEN_16(Func, 0x6) MACRO_COPY_TOKEN_16(Func, 0x7) \
+	MACRO_COPY_TOKEN_16(Func, 0x8) MACRO_COPY_TOKEN_16(Func, 0x9) \
+	MACRO_COPY_TOKEN_16(Func, 0xA) MACRO_COPY_TOKEN_16(Func, 0xB) \
+	MACRO_COPY_TOKEN_16(Func, 0xC) MACRO_COPY_TOKEN_16(Func, 0xD) \
+	MACRO_COPY_TOKEN_16(Func, 0xE) MACRO_COPY_TOKEN_16(Func, 0xF)
+
 
 ////////////////////////////////////////////////////////////
 //						proc definition
@@ -379,41 +395,59 @@ enum ProcEnum : Uint8
 //					core loop function
 ////////////////////////////////////////////////////////////
 
+//--------------------------------------------------
+//			helper macros for core loop functions
+//--------------------------------------------------
+#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+#define MACRO_FUNC_ARRAY_BODY(POS, NEXT) \
+	{ \
+		using currType = helper::GetType<func, POS>; \
+		const auto p = proc + (int)curr; \
+		curr += currType::offset; \
+		const auto ret = currType::func(data, p, curr); \
+		if (ret != RetContinue) \
+		{ \
+			if (ret == RetEnd) \
+				return; \
+			else \
+			{ \
+				curr += - currType::offset - 1; \
+				scriptExeError(proc, curr); \
+				return; \
+			} \
+		} \
+		else \
+			NEXT; \
+	}
+//--------------------------------------------------
+
+/**
+ * Reports invalid operation in script.
+ * @param proc array storing operation of script
+ * @param curr position of invalid operation
+ */
+static void scriptExeError(const Uint8* proc, ProgPos curr)
+{
+	static int bugCount = 0;
+	if (++bugCount < 100)
+	{
+		Log(LOG_ERROR) << "Invalid script operation for OpId: " << std::hex << std::showbase << (int)proc[(int)curr] <<" at "<< (int)curr;
+	}
+}
+
 /**
- * Core function in script engine used to executing scripts
+ * Core function in script engine used to executing scripts,
+ * every operation is selected by one shared switch.
  * @param proc array storing operation of script
- * @return Result of executing script
  */
-static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
+static inline void scriptExeSwitch(ScriptWorkerBase& data, const Uint8* proc)
 {
 	ProgPos curr = ProgPos::Start;
-	//--------------------------------------------------
-	//			helper macros for this function
-	//--------------------------------------------------
-	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+
 	#define MACRO_FUNC_ARRAY_LOOP(POS) \
 		case (POS): \
-		{ \
-			using currType = helper::GetType<func, POS>; \
-			const auto p = proc + (int)curr; \
-			curr += currType::offset; \
-			const auto ret = currType::func(data, p, curr); \
-			if (ret != RetContinue) \
-			{ \
-				if (ret == RetEnd) \
-					goto endLabel; \
-				else \
-				{ \
-					curr += - currType::offset - 1; \
-					goto errorLabel; \
-				} \
-			} \
-			else \
-				continue; \
-		}
-	//--------------------------------------------------
-
-	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+		MACRO_FUNC_ARRAY_BODY(POS, continue)
 
 	while (true)
 	{
@@ -423,22 +457,63 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 		}
 	}
 
-	//--------------------------------------------------
-	//			removing helper macros
-	//--------------------------------------------------
 	#undef MACRO_FUNC_ARRAY_LOOP
-	#undef MACRO_FUNC_ARRAY
-	//--------------------------------------------------
+}
 
-	errorLabel:
-	static int bugCount = 0;
-	if (++bugCount < 100)
+#if defined(__GNUC__)
+/**
+ * Core function in script engine used to executing scripts,
+ * every operation jumps directly to the next one using table of label addresses,
+ * this way each of them have own indirect jump that CPU can predict separately.
+ * @param proc array storing operation of script
+ */
+static inline void scriptExeGoto(ScriptWorkerBase& data, const Uint8* proc)
+{
+	ProgPos curr = ProgPos::Start;
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+
+	#define MACRO_FUNC_ARRAY_ADDRESS(POS) &&opLabel##POS,
+	#define MACRO_FUNC_ARRAY_NEXT goto *labels[proc[(int)curr++]]
+	#define MACRO_FUNC_ARRAY_LABEL(POS) \
+		opLabel##POS: \
+		MACRO_FUNC_ARRAY_BODY(POS, MACRO_FUNC_ARRAY_NEXT)
+
+	static const void* const labels[256] =
 	{
-		Log(LOG_ERROR) << "Invalid script operation for OpId: " << std::hex << std::showbase << (int)proc[(int)curr] <<" at "<< (int)curr;
-	}
+		MACRO_COPY_TOKEN_256(MACRO_FUNC_ARRAY_ADDRESS)
+	};
 
-	endLabel:
-	return;
+	MACRO_FUNC_ARRAY_NEXT;
+	MACRO_COPY_TOKEN_256(MACRO_FUNC_ARRAY_LABEL)
+
+	#undef MACRO_FUNC_ARRAY_LABEL
+	#undef MACRO_FUNC_ARRAY_NEXT
+	#undef MACRO_FUNC_ARRAY_ADDRESS
+}
+#endif
+
+//--------------------------------------------------
+//			removing helper macros
+//--------------------------------------------------
+#undef MACRO_FUNC_ARRAY_BODY
+#undef MACRO_FUNC_ARRAY
+//--------------------------------------------------
+
+/**
+ * Core function in script engine used to executing scripts,
+ * runs script using loop selected when it was parsed.
+ * @param c script to run
+ */
+static inline void scriptExe(ScriptWorkerBase& data, const ScriptContainerBase& c)
+{
+#if defined(__GNUC__)
+	if (c.getDispatch() == ScriptDispatch::ComputedGoto)
+	{
+		scriptExeGoto(data, c.data());
+		return;
+	}
+#endif
+	scriptExeSwitch(data, c.data());
 }
 
 
@@ -446,6 +521,85 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 //						Script class
 ////////////////////////////////////////////////////////////
 
+/**
+ * Checks if blit scripts ignore the destination pixel and do not log anything.
+ * Then all other arguments are constant in one blit, and the result depends only on the source pixel.
+ * @param proc main script.
+ * @param events global scripts run before and after main one, can be null.
+ * @return true if result can be reused for all pixels with the same source color.
+ */
+bool ScriptWorkerBlit::isPixelPure(const ScriptContainerBase& proc, const ScriptContainerBase* events)
+{
+	constexpr size_t oldPixel = offsetOutputArg<1>(helper::TypeTag<Output>{});
+
+	auto pure = [&](const ScriptContainerBase& c)
+	{
+		return !c.isRegUsed(oldPixel) && !c.isDebugUsed();
+	};
+
+	if (!pure(proc))
+	{
+		return false;
+	}
+	if (events)
+	{
+		// events before and after main script, each list ends with an empty script.
+		for (int i = 0; i < 2; ++i)
+		{
+			while (*events)
+			{
+				if (!pure(*events))
+				{
+					return false;
+				}
+				++events;
+			}
+			++events;
+		}
+	}
+	return true;
+}
+
+/**
+ * Runs blit scripts for one pixel.
+ * @param src source pixel.
+ * @param dest destination pixel.
+ * @return new pixel, 0 if destination should not change.
+ */
+int ScriptWorkerBlit::executePixel(int src, int dest)
+{
+	ScriptWorkerBlit::Output arg = { src, dest };
+	set(arg);
+	if (_events)
+	{
+		auto ptr = _events;
+		while (*ptr)
+		{
+			reset(arg);
+			executePureBase(*ptr);
+			++ptr;
+		}
+		++ptr;
+
+		reset(arg);
+		executePureBase(*_proc);
+
+		while (*ptr)
+		{
+			reset(arg);
+			executePureBase(*ptr);
+			++ptr;
+		}
+		++ptr;
+	}
+	else
+	{
+		executePureBase(*_proc);
+	}
+	get(arg);
+	return arg.getFirst();
+}
+
 void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, int shade)
 {
 	executeBlit(src, dest, x, y, shade, GraphSubset{ dest->getWidth(), dest->getHeight() } );
@@ -466,37 +620,26 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 
 	if (_proc)
 	{
-		if (_events)
+		if (_pixelPure)
 		{
+			// every color is run through scripts only once, on its first use.
+			// each run starts from the same registers, otherwise locals left by
+			// one color could leak into the next and the cache would depend on pixel order.
+			bool known[256] = { };
+			int colors[256];
+			const RegSnapshot start = saveRegs();
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						auto ptr = _events;
-						while (*ptr)
-						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
-						}
-						++ptr;
-
-						reset(arg);
-						scriptExe(*this, _proc);
-
-						while (*ptr)
+						if (!known[srcStuff])
 						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
+							known[srcStuff] = true;
+							loadRegs(start);
+							colors[srcStuff] = executePixel(srcStuff, destStuff);
 						}
-						++ptr;
-
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						if (colors[srcStuff]) destStuff = colors[srcStuff];
 					}
 				},
 				destShader,
@@ -510,11 +653,8 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						scriptExe(*this, _proc);
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						const int result = executePixel(srcStuff, destStuff);
+						if (result) destStuff = result;
 					}
 				},
 				destShader,
@@ -532,11 +672,57 @@ void ScriptWorkerBlit::executeBlit(Surface* src, Surface* dest, int x, int y, in
  * Execute script with two arguments.
  * @return Result value from script.
  */
-void ScriptWorkerBase::executeBase(const Uint8* proc)
+void ScriptWorkerBase::executeBase(const ScriptContainerBase& c)
 {
-	if (proc)
+	if (c)
 	{
-		scriptExe(*this, proc);
+		scriptExe(*this, c);
+	}
+}
+
+static int checkDispatchErrors = 0;
+
+/**
+ * Get number of scripts that gave different results with each script loop,
+ * when checking script loops is enabled.
+ */
+int ScriptWorkerBase::getCheckDispatchErrors()
+{
+	return checkDispatchErrors;
+}
+
+/**
+ * Execute script that can't change anything other than its registers.
+ * When checking script loops is enabled, it runs with both of them,
+ * and any difference in registers after them is reported.
+ */
+void ScriptWorkerBase::executePureBase(const ScriptContainerBase& c)
+{
+	if (!c)
+	{
+		return;
+	}
+	if (!Options::oxceScriptCheckDispatch || c.isDebugUsed())
+	{
+		scriptExe(*this, c);
+		return;
+	}
+
+	const ScriptRawMemory<ScriptMaxReg> before = reg;
+	scriptExeSwitch(*this, c.data());
+	const ScriptRawMemory<ScriptMaxReg> switchResult = reg;
+	reg = before;
+#if defined(__GNUC__)
+	scriptExeGoto(*this, c.data());
+#else
+	scriptExeSwitch(*this, c.data());
+#endif
+	if (std::memcmp(&switchResult, &reg, ScriptMaxReg) != 0)
+	{
+		if (++checkDispatchErrors < 100)
+		{
+			Log(LOG_ERROR) << "Script loops gave different results for script of size " << c.size();
+		}
 	}
 }
 
@@ -1210,6 +1396,7 @@ bool parseDebugLog(const ScriptProcData& spd, ParserWriter& ph, const ScriptRefD
 		return true;
 	}
 
+	ph.debugUsed = true;
 	for (auto i = begin; i != end; ++i)
 	{
 		const auto proc = ph.parser.getProc(ScriptRef{ "debug_impl" });
@@ -1762,7 +1949,9 @@ ParserWriter::ParserWriter(
 	parser(d),
 	refListCurr(),
 	regIndexUsed(regUsed),
-	constIndexUsed(-1)
+	constIndexUsed(-1),
+	regMaskUsed(0),
+	debugUsed(false)
 {
 
 }
@@ -1773,6 +1962,9 @@ ParserWriter::ParserWriter(
 void ParserWriter::relese()
 {
 	pushProc(Proc_exit);
+	container._regUsed = regMaskUsed;
+	container._debugUsed = debugUsed;
+	container._dispatch = Options::oxceScriptComputedGoto ? ScriptDispatch::ComputedGoto : ScriptDispatch::Switch;
 	refLabels.forEachPosition(
 		[&](auto pos, ProgPos value)
 		{
@@ -2046,7 +2238,12 @@ bool ParserWriter::pushRegTry(const ScriptRefData& data, ArgEnum type)
 	type = ArgSpecAdd(type, ArgSpecReg);
 	if (data && ArgCompatible(type, data.type, 0) && data.getValue<RegEnum>() != RegInvaild)
 	{
-		pushValue(static_cast<Uint8>(data.getValue<RegEnum>()));
+		const auto reg = static_cast<size_t>(data.getValue<RegEnum>());
+		if (reg < 64)
+		{
+			regMaskUsed |= Uint64{ 1 } << reg;
+		}
+		pushValue(static_cast<Uint8>(reg));
 		return true;
 	}
 	return false;
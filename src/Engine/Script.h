@@ -125,6 +125,15 @@ enum class ProgPos : size_t
 	Start = 0,
 };
 
+/**
+ * Loop used to run operations of script.
+ */
+enum class ScriptDispatch : Uint8
+{
+	Switch,
+	ComputedGoto,
+};
+
 inline ProgPos& operator+=(ProgPos& pos, int offset)
 {
 	pos = static_cast<ProgPos>(static_cast<size_t>(pos) + offset);
@@ -374,6 +383,9 @@ class ScriptContainerBase
 {
 	friend struct ParserWriter;
 	std::vector<Uint8> _proc;
+	Uint64 _regUsed = 0;
+	bool _debugUsed = false;
+	ScriptDispatch _dispatch = ScriptDispatch::Switch;
 
 public:
 	/// Constructor.
@@ -402,6 +414,27 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+	/// Get size of proc data.
+	size_t size() const
+	{
+		return _proc.size();
+	}
+	/// Get loop used to run this script.
+	ScriptDispatch getDispatch() const
+	{
+		return _dispatch;
+	}
+
+	/// Test if script could access register at given offset.
+	bool isRegUsed(size_t offset) const
+	{
+		return offset >= 64 || (_regUsed & (Uint64{ 1 } << offset));
+	}
+	/// Test if script writes anything to debug log.
+	bool isDebugUsed() const
+	{
+		return _debugUsed;
+	}
 };
 
 /**
@@ -444,6 +477,11 @@ public:
 	{
 		return _current.data();
 	}
+	/// Get script of this object without events.
+	const ScriptContainerBase& dataCurrent() const
+	{
+		return _current;
+	}
 	/// Get pointer to proc data.
 	const ScriptContainerBase* dataEvents() const
 	{
@@ -674,6 +712,27 @@ class ScriptWorkerBase
 	}
 
 protected:
+	/// Type holding copy of all registers.
+	using RegSnapshot = ScriptRawMemory<ScriptMaxReg>;
+
+	/// Copy current registers.
+	RegSnapshot saveRegs() const
+	{
+		return reg;
+	}
+	/// Restore registers from copy.
+	void loadRegs(const RegSnapshot& snapshot)
+	{
+		reg = snapshot;
+	}
+
+	/// Get offset of one of output values.
+	template<int I, typename... Args>
+	static constexpr size_t offsetOutputArg(helper::TypeTag<ScriptOutputArgs<Args...>>)
+	{
+		return offset<void, Args...>(I, 0);
+	}
+
 	/// Update values in script.
 	template<typename Output, typename... Args>
 	void updateBase(Args... args)
@@ -699,7 +758,9 @@ protected:
 	}
 
 	/// Call script.
-	void executeBase(const Uint8* proc);
+	void executeBase(const ScriptContainerBase& c);
+	/// Call script that can only change its registers.
+	void executePureBase(const ScriptContainerBase& c);
 
 public:
 	/// Default constructor.
@@ -708,6 +769,9 @@ public:
 
 	}
 
+	/// Get number of scripts that gave different results with each script loop.
+	static int getCheckDispatchErrors();
+
 	/// Get value from reg.
 	template<typename T>
 	T& ref(size_t off)
@@ -758,7 +822,7 @@ public:
 		static_assert(std::is_same<typename Parent::Output, Output>::value, "Incompatible script output type");
 
 		set(arg);
-		executeBase(c.data());
+		executeOne(c);
 		get(arg);
 	}
 
@@ -775,24 +839,41 @@ public:
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeOne(*ptr);
 				++ptr;
 			}
 			++ptr;
 		}
 		reset(arg);
-		executeBase(c.data());
+		executeOne(c.dataCurrent());
 		if (ptr)
 		{
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeOne(*ptr);
 				++ptr;
 			}
 		}
 		get(arg);
 	}
+
+private:
+	/// Scripts get only read only objects, so they can't change anything other than registers.
+	static constexpr bool pure = (... && (!std::is_pointer<Args>::value || std::is_const<typename std::remove_pointer<Args>::type>::value));
+
+	/// Call script, checking dispatch loops if it is safe.
+	void executeOne(const ScriptContainerBase& c)
+	{
+		if (pure)
+		{
+			executePureBase(c);
+		}
+		else
+		{
+			executeBase(c);
+		}
+	}
 };
 
 /**
@@ -801,15 +882,22 @@ public:
 class ScriptWorkerBlit : public ScriptWorkerBase
 {
 	/// Current script set in worker.
-	const Uint8* _proc;
+	const ScriptContainerBase* _proc;
 	const ScriptContainerBase* _events;
+	/// Result of script depends only on source pixel.
+	bool _pixelPure;
+
+	/// Test if scripts use only source pixel and constant arguments.
+	static bool isPixelPure(const ScriptContainerBase& proc, const ScriptContainerBase* events);
+	/// Run scripts for one pixel.
+	int executePixel(int src, int dest);
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr), _pixelPure(false)
 	{
 
 	}
@@ -822,8 +910,9 @@ public:
 		clear();
 		if (c)
 		{
-			_proc = c.data();
+			_proc = &c;
 			_events = nullptr;
+			_pixelPure = isPixelPure(c, nullptr);
 			updateBase<Output>(args...);
 		}
 	}
@@ -836,8 +925,9 @@ public:
 		clear();
 		if (c)
 		{
-			_proc = c.data();
+			_proc = c.dataCurrent() ? &c.dataCurrent() : nullptr;
 			_events = c.dataEvents();
+			_pixelPure = isPixelPure(c.dataCurrent(), _events);
 			updateBase<Output>(args...);
 		}
 	}
@@ -852,6 +942,7 @@ public:
 	{
 		_proc = nullptr;
 		_events = nullptr;
+		_pixelPure = false;
 	}
 };
 
@@ -151,6 +151,10 @@ struct ParserWriter
 	size_t regIndexUsed;
 	/// negative index of used const values.
 	int constIndexUsed;
+	/// bit mask of first registers used by script.
+	Uint64 regMaskUsed;
+	/// script writes to debug log.
+	bool debugUsed;
 
 	/// Store position of blocks of code like "if" or "while".
 	std::vector<Block> codeBlocks;
@@ -19,6 +19,8 @@
  */
 #include "ShaderDrawHelper.h"
 #include "HelperMeta.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <tuple>
 
 namespace OpenXcom
@@ -31,35 +33,22 @@ static inline First&& GetFirst(First&& f, Rest&&... r)
 }
 
 /**
- * Universal blit function implementation.
+ * Smallest number of lines worth giving to another thread.
+ */
+const int ShaderDrawMinBandLines = 32;
+
+/**
+ * Runs the function over lines of the final draw range.
+ * Surfaces control objects are copies, ready for `set_y`.
  * @param f called function.
+ * @param end final draw range.
+ * @param begin_y first line to draw.
+ * @param end_y line after last line to draw.
  * @param src source surfaces control objects.
  */
 template<typename Func, typename... SrcType>
-static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
+static inline void ShaderDrawLines(Func& f, const GraphSubset& end, int begin_y, int end_y, helper::controler<SrcType>... src)
 {
-	//get basic draw range in 2d space
-	GraphSubset end_temp = GetFirst(src...).get_range();
-
-	//intersections with src ranges
-	(src.mod_range(end_temp), ...);
-
-	const GraphSubset end = end_temp;
-	if (!end)
-		return;
-
-	//set final draw range in 2d space
-	(src.set_range(end), ...);
-
-
-	int begin_y = 0, end_y = end.size_y();
-
-	//determining iteration range in y-axis
-	(src.mod_y(begin_y, end_y), ...);
-
-	if(begin_y>=end_y)
-		return;
-
 	//set final iteration range
 	(src.set_y(begin_y, end_y), ...);
 
@@ -96,7 +85,58 @@ static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
 			f(src.get_ref()...); (src.inc_x(), ...);
 		}
 	}
+}
+
+/**
+ * Universal blit function implementation.
+ * @param parallel split lines between threads of the shared pool.
+ * @param f called function.
+ * @param src source surfaces control objects.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawImpl(bool parallel, Func&& f, helper::controler<SrcType>... src)
+{
+	//get basic draw range in 2d space
+	GraphSubset end_temp = GetFirst(src...).get_range();
+
+	//intersections with src ranges
+	(src.mod_range(end_temp), ...);
+
+	const GraphSubset end = end_temp;
+	if (!end)
+		return;
+
+	//set final draw range in 2d space
+	(src.set_range(end), ...);
+
+
+	int begin_y = 0, end_y = end.size_y();
+
+	//determining iteration range in y-axis
+	(src.mod_y(begin_y, end_y), ...);
+
+	if(begin_y>=end_y)
+		return;
+
+	int bands = 1;
+	if (parallel)
+	{
+		bands = std::min(ThreadPool::getShared().getThreadCount() * 2, (end_y - begin_y) / ShaderDrawMinBandLines);
+	}
+	if (bands <= 1)
+	{
+		ShaderDrawLines(f, end, begin_y, end_y, src...);
+		return;
+	}
 
+	//every band works on its own copy of surfaces control objects
+	ThreadPool::getShared().run(bands,
+		[&](size_t band, int)
+		{
+			int size_y = end_y - begin_y;
+			ShaderDrawLines(f, end, begin_y + (int)(size_y * band / bands), begin_y + (int)(size_y * (band + 1) / bands), src...);
+		}
+	);
 };
 
 /**
@@ -108,7 +148,20 @@ static inline void ShaderDrawImpl(Func&& f, helper::controler<SrcType>... src)
 template<typename ColorFunc, typename... SrcType>
 static inline void ShaderDraw(const SrcType&... src_frame)
 {
-	ShaderDrawImpl([](auto&&... a){ ColorFunc::func(std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
+	ShaderDrawImpl(false, [](auto&&... a){ ColorFunc::func(std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
+}
+
+/**
+ * Universal blit function, with lines split in bands between threads.
+ * Only for `ColorFunc` that change nothing else than the current pixel
+ * of the destination, every pixel of destination must be set by at most one call.
+ * @tparam ColorFunc class that contains static function `func`.
+ * @param src_frame destination and source surfaces modified by function.
+ */
+template<typename ColorFunc, typename... SrcType>
+static inline void ShaderDrawParallel(const SrcType&... src_frame)
+{
+	ShaderDrawImpl(true, [](auto&&... a){ ColorFunc::func(std::forward<decltype(a)>(a)...); }, helper::controler<SrcType>(src_frame)...);
 }
 
 /**
@@ -119,7 +172,19 @@ static inline void ShaderDraw(const SrcType&... src_frame)
 template<typename Func, typename... SrcType>
 static inline void ShaderDrawFunc(Func&& f, const SrcType&... src_frame)
 {
-	ShaderDrawImpl(std::forward<Func>(f), helper::controler<SrcType>(src_frame)...);
+	ShaderDrawImpl(false, std::forward<Func>(f), helper::controler<SrcType>(src_frame)...);
+}
+
+/**
+ * Universal blit function, with lines split in bands between threads.
+ * Same restrictions as `ShaderDrawParallel`, and `f` is called from all threads at once.
+ * @param f function that modify other arguments.
+ * @param src_frame destination and source surfaces modified by function.
+ */
+template<typename Func, typename... SrcType>
+static inline void ShaderDrawFuncParallel(Func&& f, const SrcType&... src_frame)
+{
+	ShaderDrawImpl(true, std::forward<Func>(f), helper::controler<SrcType>(src_frame)...);
 }
 
 namespace helper
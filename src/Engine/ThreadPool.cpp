@@ -0,0 +1,184 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreadPool.h"
+#include <algorithm>
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Set on threads that are running work of a pool, nested runs are done serially.
+thread_local bool insidePool = false;
+
+}
+
+/**
+ * Starts the worker threads.
+ * @param threads Number of threads doing the work, including the calling one.
+ * Values below 1 use the number of cores.
+ */
+ThreadPool::ThreadPool(int threads) : _task(0), _next(0), _count(0), _generation(0), _busy(0), _quit(false)
+{
+	if (threads < 1)
+	{
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	}
+	for (int i = 1; i < threads; ++i)
+	{
+		_workers.push_back(std::thread(&ThreadPool::loop, this, i));
+	}
+}
+
+/**
+ * Stops and joins the worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wakeUp.notify_all();
+	for (std::vector<std::thread>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+	{
+		i->join();
+	}
+}
+
+/**
+ * Takes work items one by one until all of them are handed out.
+ * @param thread Index of the running thread.
+ */
+void ThreadPool::work(int thread)
+{
+	insidePool = true;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (_next < _count)
+	{
+		size_t index = _next++;
+		lock.unlock();
+		try
+		{
+			(*_task)(index, thread);
+		}
+		catch (...)
+		{
+			lock.lock();
+			if (!_error)
+			{
+				_error = std::current_exception();
+			}
+			_next = _count;
+			continue;
+		}
+		lock.lock();
+	}
+	insidePool = false;
+}
+
+/**
+ * Waits for new work and runs it.
+ * @param thread Index of the worker thread.
+ */
+void ThreadPool::loop(int thread)
+{
+	unsigned generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeUp.wait(lock, [&]{ return _quit || _generation != generation; });
+			if (_quit)
+			{
+				return;
+			}
+			generation = _generation;
+			++_busy;
+		}
+		work(thread);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_busy;
+		}
+		_finished.notify_all();
+	}
+}
+
+/**
+ * Runs a task for every index from 0 to count - 1. Work items are handed out
+ * in order, but can finish in any order, so the task needs to store its results
+ * by index and the caller has to combine them afterwards.
+ * If a task throws, the remaining items are skipped and the exception is
+ * rethrown here.
+ * @param count Number of work items.
+ * @param task Task to run for each item.
+ */
+void ThreadPool::run(size_t count, const Task &task)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (_workers.empty() || count == 1 || insidePool)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			task(i, 0);
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_next = 0;
+		_count = count;
+		_error = nullptr;
+		++_generation;
+	}
+	_wakeUp.notify_all();
+	work(0);
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_finished.wait(lock, [&]{ return _next == _count && _busy == 0; });
+		_task = 0;
+		std::swap(error, _error);
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+/**
+ * Gets the pool shared by the engine, created on first use
+ * with the number of threads set in the options.
+ * @return Shared thread pool.
+ */
+ThreadPool &ThreadPool::getShared()
+{
+	static ThreadPool shared(Options::oxceThreads);
+	return shared;
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Small pool of worker threads used to split independent work
+ * (like per unit visibility) between the available cores.
+ * The thread calling run() takes part in the work too.
+ */
+class ThreadPool
+{
+public:
+	/// Work item, gets the index of the item and the index of the thread running it.
+	typedef std::function<void(size_t index, int thread)> Task;
+
+private:
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _wakeUp, _finished;
+	const Task *_task;
+	size_t _next, _count;
+	unsigned _generation;
+	int _busy;
+	bool _quit;
+	std::exception_ptr _error;
+
+	/// Runs work items until none are left.
+	void work(int thread);
+	/// Main loop of a worker thread.
+	void loop(int thread);
+public:
+	/// Creates a pool with the given number of threads.
+	ThreadPool(int threads);
+	/// Stops the worker threads.
+	~ThreadPool();
+	/// Gets the number of threads doing the work, including the calling one.
+	int getThreadCount() const { return (int)_workers.size() + 1; }
+	/// Runs a task for every index in the range and waits for all of them.
+	void run(size_t count, const Task &task);
+	/// Gets the pool shared by the engine.
+	static ThreadPool &getShared();
+};
+
+}
@@ -19,10 +19,13 @@
 
 #include "Zoom.h"
 
+#include <algorithm>
+
 #include "Surface.h"
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "ThreadPool.h"
 
 #include "OpenGL.h"
 
@@ -647,6 +650,36 @@ bool Zoom::haveSSE2()
 
 #endif
 
+/// Smallest number of source rows given to one band of a threaded scaler.
+static const int ScalerMinBandRows = 16;
+
+/**
+ * Runs a row slice scaler over the source image in horizontal bands on the
+ * shared thread pool. The scaler reads its neighbour rows itself, so the
+ * bands only split the rows written and never overlap in the output.
+ *
+ * @param yFirst First source row to scale.
+ * @param yLast Source row past the last one to scale.
+ * @param func Scaler called with each half-open band of rows.
+ */
+template<typename Func>
+static void scaleInBands(int yFirst, int yLast, Func func)
+{
+	ThreadPool &pool = ThreadPool::getShared();
+	int rows = yLast - yFirst;
+	int bands = std::min(pool.getThreadCount() * 2, rows / ScalerMinBandRows);
+	if (bands <= 1)
+	{
+		func(yFirst, yLast);
+		return;
+	}
+	pool.run(bands, [&](size_t band, int)
+		{
+			func(yFirst + (int)(rows * band / bands), yFirst + (int)(rows * (band + 1) / bands));
+		}
+	);
+}
+
 /**
  * Wrapper around various software and OpenGL screen buffer pushing functions which zoom.
  * Basically called just from Screen::flip()
@@ -658,11 +691,15 @@ bool Zoom::haveSSE2()
  * @param leftBlackBand Size of left black band in pixels (letterboxing).
  * @param rightBlackBand Size of right black band in pixels (letterboxing).
  * @param glOut OpenGL output.
+ * @param yFirst First source row that needs to be drawn.
+ * @param yLast Source row past the last one that needs to be drawn.
  */
-void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut)
+void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, int yFirst, int yLast)
 {
 	int dstWidth = dst->w - leftBlackBand - rightBlackBand;
 	int dstHeight = dst->h - topBlackBand - bottomBlackBand;
+	yFirst = std::max(yFirst, 0);
+	yLast = std::min(yLast, src->h);
 	if (Screen::useOpenGL())
 	{
 #ifndef __NO_OPENGL
@@ -677,27 +714,47 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (topBlackBand <= 0 && bottomBlackBand <= 0 && leftBlackBand <= 0 && rightBlackBand <= 0)
 	{
-		_zoomSurfaceY(src, dst, 0, 0);
+		_zoomSurfaceY(src, dst, 0, 0, yFirst, yLast);
 	}
 	else if (dstWidth == src->w && dstHeight == src->h)
 	{
-		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)src->w, (Uint16)src->h};
-		SDL_BlitSurface(src, NULL, dst, &dstrect);
+		SDL_Rect srcrect = {0, (Sint16)yFirst, (Uint16)src->w, (Uint16)(yLast - yFirst)};
+		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)(topBlackBand + yFirst), (Uint16)src->w, (Uint16)(yLast - yFirst)};
+		SDL_BlitSurface(src, &srcrect, dst, &dstrect);
 	}
 	else
 	{
 		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dstWidth, dstHeight, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
+		_zoomSurfaceY(src, tmp, 0, 0, yFirst, yLast);
 		if (src->format->palette != NULL)
 		{
 			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
 		}
-		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)tmp->w, (Uint16)tmp->h};
-		SDL_BlitSurface(tmp, NULL, dst, &dstrect);
+		// only the rows drawn from the source slice are valid in tmp
+		int tmpFirst = yFirst, tmpLast = yLast;
+		getZoomedRows(src->h, tmp->h, tmpFirst, tmpLast);
+		SDL_Rect srcrect = {0, (Sint16)tmpFirst, (Uint16)tmp->w, (Uint16)(tmpLast - tmpFirst)};
+		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)(topBlackBand + tmpFirst), (Uint16)tmp->w, (Uint16)(tmpLast - tmpFirst)};
+		SDL_BlitSurface(tmp, &srcrect, dst, &dstrect);
 		SDL_FreeSurface(tmp);
 	}
 }
 
+/**
+ * Converts a slice of source rows to the slice of destination rows
+ * that are drawn from it by the zoomers, which all sample source
+ * row (y * srcHeight / dstHeight) for destination row y.
+ * @param srcHeight Height of the source surface.
+ * @param dstHeight Height of the zoomed surface.
+ * @param yFirst First source row, returns the first zoomed row.
+ * @param yLast Source row past the last one, returns the zoomed row past the last one.
+ */
+void Zoom::getZoomedRows(int srcHeight, int dstHeight, int &yFirst, int &yLast)
+{
+	yFirst = (yFirst * dstHeight + srcHeight - 1) / srcHeight;
+	yLast = (yLast * dstHeight + srcHeight - 1) / srcHeight;
+}
+
 
 /**
  * Internal 8-bit Zoomer without smoothing.
@@ -711,9 +768,11 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
  * @param dst The zoomed surface (output).
  * @param flipx Flag indicating if the image should be horizontally flipped.
  * @param flipy Flag indicating if the image should be vertically flipped.
+ * @param yFirst First source row that needs to be drawn.
+ * @param yLast Source row past the last one that needs to be drawn.
  * @return 0 for success or -1 for error.
  */
-int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int yFirst, int yLast)
 {
 	int x, y;
 	static Uint32 *sax, *say;
@@ -723,6 +782,9 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	int dgap;
 	static bool proclaimed = false;
 
+	yFirst = std::max(yFirst, 0);
+	yLast = std::min(yLast, src->h);
+
 	if (Screen::use32bitScaler())
 	{
 		if (Options::useXBRZFilter)
@@ -732,7 +794,11 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					scaleInBands(yFirst, yLast, [&](int bandFirst, int bandLast)
+						{
+							xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB, xbrz::ScalerCfg(), bandFirst, bandLast);
+						}
+					);
 					return 0;
 				}
 			}
@@ -748,23 +814,35 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 				initDone = true;
 			}
 
-			// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
+			// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
 
 			if (dst->w == src->w * 2 && dst->h == src->h * 2)
 			{
-				hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(yFirst, yLast, [&](int bandFirst, int bandLast)
+					{
+						hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, bandFirst, bandLast);
+					}
+				);
 				return 0;
 			}
 
 			if (dst->w == src->w * 3 && dst->h == src->h * 3)
 			{
-				hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(yFirst, yLast, [&](int bandFirst, int bandLast)
+					{
+						hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, bandFirst, bandLast);
+					}
+				);
 				return 0;
 			}
 
 			if (dst->w == src->w * 4 && dst->h == src->h * 4)
 			{
-				hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(yFirst, yLast, [&](int bandFirst, int bandLast)
+					{
+						hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, bandFirst, bandLast);
+					}
+				);
 				return 0;
 			}
 		}
@@ -888,10 +966,23 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		csay++;
 	}
 	/*
-	* Draw
+	* Draw, skipping the rows outside of the source slice
 	*/
+	int dstFirst = yFirst, dstLast = yLast;
+	if (flipy)
+	{
+		dstFirst = 0;
+		dstLast = src->h;
+	}
+	getZoomedRows(src->h, dst->h, dstFirst, dstLast);
 	csay = say;
 	for (y = 0; y < dst->h; y++) {
+		if (y < dstFirst || y >= dstLast) {
+			csp += (*csay);
+			csay++;
+			dp += dst->pitch;
+			continue;
+		}
 		csax = sax;
 		sp = csp;
 		for (x = 0; x < dst->w; x++) {
@@ -17,6 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <climits>
 #include <SDL.h>
 #include "OpenGL.h"
 
@@ -29,9 +30,11 @@ class Zoom
 
 	public:
 	/// Flip screen given src and dst; might use software or OpenGL.
-	static void flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut);
+	static void flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, int yFirst = 0, int yLast = INT_MAX);
 	/// Copy src to dst, resizing as needed. Please don't use flipx or flipy as the optimized functions ignore these parameters.
-	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
+	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int yFirst = 0, int yLast = INT_MAX);
+	/// Gets the rows of a zoomed surface that are drawn from a slice of source rows.
+	static void getZoomedRows(int srcHeight, int dstHeight, int &yFirst, int &yLast);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2();
 
@@ -164,7 +164,7 @@ std::string ConfirmDestinationState::checkStartingCondition()
 
 	// check required item(s)
 	auto requiredItems = rule->getRequiredItems();
-	if (!_craft->areRequiredItemsOnboard(requiredItems))
+	if (!_craft->areRequiredItemsOnboard(requiredItems, _game->getMod()))
 	{
 		std::ostringstream ss2;
 		int i2 = 0;
@@ -307,7 +307,7 @@ void ConfirmDestinationState::btnTransferClick(Action *)
 	{
 		errorMessage = tr("STR_NO_FREE_ACCOMODATION_CREW");
 	}
-	else if (Options::storageLimitsEnforced && targetBase->storesOverfull(_craft->getTotalItemStorageSize(_game->getMod())))
+	else if (Options::storageLimitsEnforced && targetBase->storesOverfull(_craft->getTotalItemStorageSize()))
 	{
 		errorMessage = tr("STR_NOT_ENOUGH_STORE_SPACE_FOR_CRAFT");
 	}
@@ -118,6 +118,23 @@ struct Cord
 	}
 };
 
+/**
+ * Single precision copy of a Cord, for big per pixel tables.
+ */
+struct CordFloat
+{
+	float x, y, z;
+
+	inline CordFloat() : x(0.0f), y(0.0f), z(0.0f)
+	{
+
+	}
+	explicit inline CordFloat(const Cord& c) : x((float)c.x), y((float)c.y), z((float)c.z)
+	{
+
+	}
+};
+
 inline Cord::Cord(const CordPolar& pol)
 {
 	x = std::sin(pol.lon) * std::cos(pol.lat);
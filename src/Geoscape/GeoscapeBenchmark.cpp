@@ -0,0 +1,381 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeBenchmark.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include "DogfightState.h"
+#include "GeoscapeState.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Screen.h"
+#include "../Engine/Timer.h"
+#include "../Interface/TextButton.h"
+#include "../Mod/Mod.h"
+#include "../Mod/RuleGlobe.h"
+#include "../Mod/RuleRegion.h"
+#include "../Savegame/AlienBase.h"
+#include "../Savegame/Base.h"
+#include "../Savegame/Craft.h"
+#include "../Savegame/GameTime.h"
+#include "../Savegame/MissionSite.h"
+#include "../Savegame/Region.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/Ufo.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Number of 5 second steps in a day, the span of the "1 Day" speed.
+const int StepsPerDay = 12 * 60 * 24;
+
+std::string getStringArg(const std::map<std::string, std::string> &args, const std::string &name, const std::string &def)
+{
+	auto i = args.find(name);
+	return i != args.end() ? i->second : def;
+}
+
+template<typename T>
+T getNumberArg(const std::map<std::string, std::string> &args, const std::string &name, T def)
+{
+	auto i = args.find(name);
+	if (i != args.end())
+	{
+		std::istringstream ss(i->second);
+		ss >> def;
+	}
+	return def;
+}
+
+}
+
+/**
+ * Sets up the benchmark.
+ * @param game Pointer to the core game, with mods already loaded.
+ * @param args Command line arguments (lowercase names without dashes).
+ */
+GeoscapeBenchmark::GeoscapeBenchmark(Game *game, const std::map<std::string, std::string> &args) : _game(game), _geoState(0), _popups(0), _dogfights(0), _landings(0), _battles(0)
+{
+	_load = getStringArg(args, "load", "");
+	_seed = getNumberArg<uint64_t>(args, "seed", 1);
+	_months = getNumberArg(args, "months", 3);
+	_difficulty = getNumberArg(args, "difficulty", 0);
+	Options::oxceGeoFastForward = getNumberArg(args, "fastforward", Options::oxceGeoFastForward);
+}
+
+/**
+ * Cleans up the benchmark.
+ */
+GeoscapeBenchmark::~GeoscapeBenchmark()
+{
+	Profiler::enabled = false;
+}
+
+/**
+ * Creates a new game the same way the "New Game" screen does,
+ * placing and naming the starting base like the player would.
+ */
+void GeoscapeBenchmark::initSave()
+{
+	Mod *mod = _game->getMod();
+	SavedGame *save = mod->newSave((GameDifficulty)_difficulty);
+	_game->setSavedGame(save);
+
+	Base *base = save->getBases()->front();
+	if (base->getLongitude() == 0.0 && base->getLatitude() == 0.0 && !save->getRegions()->empty())
+	{
+		// middle of the first area of the first region
+		const RuleRegion *region = save->getRegions()->front()->getRules();
+		double lon = (region->getLonMin().front() + region->getLonMax().front()) / 2;
+		double lat = (region->getLatMin().front() + region->getLatMax().front()) / 2;
+		base->setLongitude(lon);
+		base->setLatitude(lat);
+		for (auto* craft : *base->getCrafts())
+		{
+			craft->setLongitude(lon);
+			craft->setLatitude(lat);
+		}
+	}
+	if (base->getName().empty())
+	{
+		base->setName("Benchmark");
+	}
+}
+
+/**
+ * Loads the save (or creates a new game) and sets up
+ * the geoscape running at the "1 Day" speed.
+ */
+void GeoscapeBenchmark::generate()
+{
+	if (_load.empty())
+	{
+		RNG::setSeed(_seed);
+		initSave();
+	}
+	else
+	{
+		SavedGame *save = new SavedGame();
+		try
+		{
+			save->load(_load, _game->getMod(), _game->getLanguage());
+		}
+		catch (...)
+		{
+			delete save;
+			throw;
+		}
+		_game->setSavedGame(save);
+		if (save->getEnding() != END_NONE)
+		{
+			throw Exception("Save is of a finished game: " + _load);
+		}
+		if (save->getSavedBattle() != 0)
+		{
+			throw Exception("Save is in the middle of a battle: " + _load);
+		}
+		// same run every time, whatever the save was at
+		RNG::setSeed(_seed);
+	}
+
+	Options::baseXResolution = Options::baseXGeoscape;
+	Options::baseYResolution = Options::baseYGeoscape;
+	_game->getScreen()->resetDisplay(false);
+
+	_geoState = new GeoscapeState;
+	_game->setState(_geoState);
+	_geoState->init();
+	skipInteraction();
+}
+
+/**
+ * Throws away the popups and dogfights queued by the time handlers
+ * and any state they pushed, sends crafts that reached a landing site
+ * back home and discards pending battles, as if the player skipped
+ * all of them. Also puts the timer back on the "1 Day" speed
+ * after the handlers reset it.
+ */
+void GeoscapeBenchmark::skipInteraction()
+{
+	SavedGame *save = _game->getSavedGame();
+
+	for (auto* state : _geoState->_popups)
+	{
+		delete state;
+		++_popups;
+	}
+	_geoState->_popups.clear();
+
+	for (auto* list : { &_geoState->_dogfights, &_geoState->_dogfightsToBeStarted })
+	{
+		for (auto* dogfight : *list)
+		{
+			Craft *craft = dogfight->getCraft();
+			craft->setInDogfight(false);
+			craft->setInterceptionOrder(0);
+			craft->returnToBase();
+			delete dogfight;
+			++_dogfights;
+		}
+		list->clear();
+	}
+	_geoState->_minimizedDogfights = 0;
+	_geoState->_dogfightStartTimer->stop();
+	_geoState->_dogfightTimer->stop();
+	_geoState->_zoomInEffectTimer->stop();
+	_geoState->_zoomOutEffectTimer->stop();
+
+	// a landing would ask for confirmation every step
+	for (auto* base : *save->getBases())
+	{
+		for (auto* craft : *base->getCrafts())
+		{
+			Target *target = craft->getDestination();
+			bool site = dynamic_cast<Ufo*>(target) || dynamic_cast<MissionSite*>(target) || dynamic_cast<AlienBase*>(target);
+			if (site && craft->reachedDestination())
+			{
+				craft->returnToBase();
+				++_landings;
+			}
+		}
+	}
+
+	// base defense goes straight to the briefing
+	if (save->getSavedBattle() != 0)
+	{
+		save->setBattleGame(0);
+		++_battles;
+	}
+	while (!_game->isState(_geoState))
+	{
+		_game->popState();
+	}
+
+	_geoState->_pause = false;
+	_geoState->_timeSpeed = _geoState->_btn1Day;
+}
+
+/**
+ * Prints a line with the simulation speed and the time spent
+ * in each geoscape time handler.
+ * @param out Output stream.
+ * @param label Line label.
+ * @param wallMs Total wall clock time for the line.
+ * @param steps Number of 5 second steps simulated.
+ */
+void GeoscapeBenchmark::report(std::ostream &out, const std::string &label, double wallMs, int steps) const
+{
+	double days = (double)steps / StepsPerDay;
+	out << std::left << std::setw(18) << label << std::right << std::fixed << std::setprecision(1);
+	out << " total " << std::setw(9) << wallMs << " ms";
+	out << " | " << std::setw(7) << (wallMs > 0 ? days * 1000 / wallMs : 0.0) << " days/s";
+	// only the geoscape sections, battlescape ones are never hit here
+	for (int i = PROF_GEO_TIME_5SEC; i < PROF_MAX; ++i)
+	{
+		ProfilerSection section = (ProfilerSection)i;
+		out << " | " << Profiler::getName(section) << " " << Profiler::getMilliseconds(section) << " ms/" << Profiler::getCounter(section).calls;
+	}
+	out << std::endl;
+}
+
+/**
+ * Lets the geoscape time run month after month, printing one
+ * line of timings per month. Nothing is drawn, everything that
+ * would wait for the player is skipped.
+ * @param out Output stream for the report.
+ * @return Process exit code.
+ */
+int GeoscapeBenchmark::run(std::ostream &out)
+{
+	SavedGame *save = _game->getSavedGame();
+
+	out << "Geoscape: " << (_load.empty() ? "new game" : _load) << " seed " << _seed;
+	out << " bases " << save->getBases()->size() << " fast forward " << (Options::oxceGeoFastForward ? "on" : "off") << std::endl;
+
+	std::chrono::steady_clock::duration total = std::chrono::steady_clock::duration::zero();
+	int totalSteps = 0;
+
+	for (int month = 0; month < _months && save->getEnding() == END_NONE; ++month)
+	{
+		std::ostringstream label;
+		label << save->getTime()->getYear() << "-" << std::setfill('0') << std::setw(2) << save->getTime()->getMonth();
+
+		int target = save->getMonthsPassed() + 1;
+		int steps = 0;
+		Profiler::reset();
+		Profiler::enabled = true;
+		auto start = std::chrono::steady_clock::now();
+		while (save->getMonthsPassed() < target && save->getEnding() == END_NONE)
+		{
+			steps += _geoState->runTimeSteps(StepsPerDay);
+			skipInteraction();
+		}
+		auto now = std::chrono::steady_clock::now();
+		Profiler::enabled = false;
+
+		total += now - start;
+		totalSteps += steps;
+		report(out, label.str(), std::chrono::duration<double, std::milli>(now - start).count(), steps);
+	}
+
+	if (save->getEnding() != END_NONE)
+	{
+		out << "Game ended on " << save->getTime()->getYear() << "-" << save->getTime()->getMonth() << "-" << save->getTime()->getDay() << std::endl;
+	}
+	double totalMs = std::chrono::duration<double, std::milli>(total).count();
+	out << "Total: " << std::fixed << std::setprecision(1) << totalMs << " ms, ";
+	out << (totalMs > 0 ? (double)totalSteps / StepsPerDay * 1000 / totalMs : 0.0) << " days/s";
+	out << ", skipped " << _popups << " popups, " << _dogfights << " dogfights, " << _landings << " landings, " << _battles << " battles" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Looks up the land polygon of every point of a dense lon/lat grid
+ * both through the polygon grid and by testing every polygon,
+ * and reports any point where the two disagree.
+ * @param game Pointer to the game with the mods loaded.
+ * @param args Settings from the command line.
+ * @param out Output stream.
+ * @return EXIT_SUCCESS if all the answers match.
+ */
+int GeoscapeBenchmark::checkGlobe(Game *game, const std::map<std::string, std::string> &args, std::ostream &out)
+{
+	const RuleGlobe *globe = game->getMod()->getGlobe();
+	double step = Deg2Rad(getNumberArg(args, "step", 0.1));
+	if (step <= 0)
+	{
+		throw Exception("Invalid step");
+	}
+
+	std::vector<std::pair<double, double> > points;
+	for (double lat = -M_PI_2; lat <= M_PI_2; lat += step)
+	{
+		for (double lon = 0; lon < 2 * M_PI; lon += step)
+		{
+			points.push_back(std::make_pair(lon, lat));
+		}
+	}
+
+	std::vector<Polygon*> expected, found;
+	expected.reserve(points.size());
+	found.reserve(points.size());
+	auto start = std::chrono::steady_clock::now();
+	for (std::vector<std::pair<double, double> >::const_iterator i = points.begin(); i != points.end(); ++i)
+	{
+		expected.push_back(globe->getPolygonAt(i->first, i->second, false));
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (std::vector<std::pair<double, double> >::const_iterator i = points.begin(); i != points.end(); ++i)
+	{
+		found.push_back(globe->getPolygonAt(i->first, i->second));
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	int mismatches = 0;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		if (expected[i] != found[i])
+		{
+			if (mismatches < 20)
+			{
+				out << "Mismatch at lon " << Rad2Deg(points[i].first) << ", lat " << Rad2Deg(points[i].second) << std::endl;
+			}
+			++mismatches;
+		}
+	}
+
+	out << std::fixed << std::setprecision(1);
+	out << points.size() << " points, all polygons: " << std::chrono::duration<double, std::milli>(middle - start).count() << " ms";
+	out << ", polygon grid: " << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+	out << mismatches << " mismatches" << std::endl;
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+namespace OpenXcom
+{
+
+class Game;
+class GeoscapeState;
+
+/**
+ * Headless geoscape simulation used for performance measurements.
+ * Loads a save or starts a new game and lets the time run at
+ * the fastest speed for a number of months, dropping everything
+ * that would wait for the player (popups, dogfights, landings,
+ * base defenses), and reports how much time was spent in the
+ * geoscape time handlers every month.
+ */
+class GeoscapeBenchmark
+{
+private:
+	Game *_game;
+	std::string _load;
+	uint64_t _seed;
+	int _months, _difficulty;
+	GeoscapeState *_geoState;
+	int _popups, _dogfights, _landings, _battles;
+
+	/// Creates a new game with the starting base placed on the globe.
+	void initSave();
+	/// Drops everything that would wait for the player.
+	void skipInteraction();
+	/// Prints timings collected since the last reset.
+	void report(std::ostream &out, const std::string &label, double wallMs, int steps) const;
+public:
+	/// Creates a benchmark with the settings from the command line.
+	GeoscapeBenchmark(Game *game, const std::map<std::string, std::string> &args);
+	/// Cleans up the benchmark.
+	~GeoscapeBenchmark();
+	/// Loads or creates the game.
+	void generate();
+	/// Runs the geoscape and reports timings.
+	int run(std::ostream &out);
+	/// Compares the globe polygon grid against testing every polygon.
+	static int checkGlobe(Game *game, const std::map<std::string, std::string> &args, std::ostream &out);
+};
+
+}
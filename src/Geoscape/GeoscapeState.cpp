@@ -122,6 +122,7 @@
 #include "../Menu/ListSaveState.h"
 #include "../Mod/RuleGlobe.h"
 #include "../Engine/Exception.h"
+#include "../Engine/Profiler.h"
 #include "../Mod/AlienDeployment.h"
 #include "../Mod/RuleInterface.h"
 #include "../Mod/RuleVideo.h"
@@ -551,7 +552,7 @@ void GeoscapeState::handle(Action *action)
 						auto *item = _game->getMod()->getItem(itemRule);
 						if (item && item->isRecoverable() && !item->isAlien() && item->getSellCost() > 0)
 						{
-							base->getStorageItems()->addItem(itemRule, 2);
+							base->getStorageItems()->addItem(item, 2);
 						}
 					}
 				}
@@ -567,7 +568,7 @@ void GeoscapeState::handle(Action *action)
 						auto *item = _game->getMod()->getItem(itemRule);
 						if (item && item->isRecoverable() && item->isAlien() && item->getSellCost() > 0)
 						{
-							base->getStorageItems()->addItem(itemRule, 2);
+							base->getStorageItems()->addItem(item, 2);
 						}
 					}
 				}
@@ -833,8 +834,25 @@ void GeoscapeState::timeAdvance()
 		timeSpan = 12 * 5 * 6 * 2 * 24;
 	}
 
+	runTimeSteps(timeSpan);
 
-	for (int i = 0; i < timeSpan && !_pause; ++i)
+	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
+
+	timeDisplay();
+	_globe->draw();
+}
+
+/**
+ * Advances the game time by a number of 5 second steps
+ * and calls the respective triggers, stopping early if
+ * something pauses the game.
+ * @param timeSpan Number of 5 second steps to advance.
+ * @return Number of steps actually advanced.
+ */
+int GeoscapeState::runTimeSteps(int timeSpan)
+{
+	int i = 0;
+	for (; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
@@ -858,12 +876,127 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+
+		// jump over the steps where nothing can happen, up to the next 10 minute trigger
+		if (Options::oxceGeoFastForward)
+		{
+			int steps = getQuietSteps(std::min(timeSpan - i - 1, _game->getSavedGame()->getTime()->getStepsToNext10Minutes() - 1));
+			if (steps > 0)
+			{
+				skipQuietSteps(steps);
+				i += steps;
+			}
+		}
 	}
+	return i;
+}
 
-	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
+/**
+ * Gets how many of the following 5 second steps would do nothing
+ * but move UFOs towards distant fixed destinations and count down
+ * landed UFOs. Anything that could lead to an interaction (craft outside,
+ * dogfights, hunting or escorting UFOs, arrivals, shield recharge)
+ * keeps the regular step by step processing.
+ * @param maxSteps Upper limit of steps to skip.
+ * @return Number of steps that can be skipped.
+ */
+int GeoscapeState::getQuietSteps(int maxSteps) const
+{
+	const SavedGame *save = _game->getSavedGame();
+	if (maxSteps <= 0 || _pause || !_popups.empty() || !_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return 0;
+	}
+	if (save->getBases()->empty() || save->getEnding() != END_NONE)
+	{
+		return 0;
+	}
+	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && _game->getMod()->getHunterKillerFastRetarget())
+	{
+		return 0;
+	}
 
-	timeDisplay();
-	_globe->draw();
+	for (auto base : *save->getBases())
+	{
+		for (auto craft : *base->getCrafts())
+		{
+			if (craft->isDestroyed() || craft->getStatus() == "STR_OUT" || craft->getDestination() != 0)
+			{
+				return 0;
+			}
+			if (craft->getShield() < craft->getCraftStats().shieldCapacity && craft->getCraftStats().shieldRechargeInGeoscape != 0)
+			{
+				return 0;
+			}
+		}
+	}
+
+	int steps = maxSteps;
+	for (auto ufo : *save->getUfos())
+	{
+		switch (ufo->getStatus())
+		{
+		case Ufo::FLYING:
+			if (ufo->isHunting() || ufo->isEscorting() || ufo->reachedDestination())
+			{
+				return 0;
+			}
+			if (ufo->getShield() == -1 || (ufo->getShield() < ufo->getCraftStats().shieldCapacity && ufo->getCraftStats().shieldRechargeInGeoscape != 0))
+			{
+				return 0;
+			}
+			if (ufo->getDestination() != 0 && ufo->getSpeedRadian() > 0)
+			{
+				if (dynamic_cast<MovingTarget*>(ufo->getDestination()))
+				{
+					return 0;
+				}
+				// stay a couple of steps short, arriving is handled step by step
+				int stepsLeft = (int)(ufo->getDistance(ufo->getDestination()) / ufo->getSpeedRadian()) - 2;
+				steps = std::min(steps, stepsLeft);
+			}
+			break;
+		case Ufo::LANDED:
+			// the step that lifts off again is a regular one
+			steps = std::min(steps, (int)(ufo->getSecondsRemaining() / 5) - 1);
+			break;
+		case Ufo::CRASHED:
+			if (!ufo->getDetected() || ufo->getSecondsRemaining() == 0)
+			{
+				return 0;
+			}
+			break;
+		case Ufo::DESTROYED:
+			return 0;
+		}
+		if (steps <= 0)
+		{
+			return 0;
+		}
+	}
+	return steps;
+}
+
+/**
+ * Skips several 5 second steps at once. Flying UFOs follow the
+ * great circle in one go, which only differs from the step by step
+ * path by rounding.
+ * @param steps Number of steps, as returned by getQuietSteps().
+ */
+void GeoscapeState::skipQuietSteps(int steps)
+{
+	_game->getSavedGame()->getTime()->skipSteps(steps);
+	for (auto ufo : *_game->getSavedGame()->getUfos())
+	{
+		if (ufo->getStatus() == Ufo::FLYING)
+		{
+			ufo->moveSteps(steps);
+		}
+		else if (ufo->getStatus() == Ufo::LANDED)
+		{
+			ufo->setSecondsRemaining(ufo->getSecondsRemaining() - steps * 5);
+		}
+	}
 }
 
 /**
@@ -892,6 +1025,7 @@ const std::vector<Craft*>* GeoscapeState::updateActiveCrafts()
  */
 void GeoscapeState::time5Seconds()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_5SEC);
 	// If in "slow mode", handle UFO hunting and escorting logic every 5 seconds, not only every 10 minutes
 	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && _game->getMod()->getHunterKillerFastRetarget())
 	{
@@ -1465,6 +1599,7 @@ struct SetRetaliationTarget
  */
 void GeoscapeState::time10Minutes()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_10MIN);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		// Fuel consumption for XCOM craft.
@@ -1768,6 +1903,7 @@ bool GeoscapeState::processMissionSite(MissionSite *site)
  */
 void GeoscapeState::time30Minutes()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_30MIN);
 	// Decrease mission countdowns
 	for (auto am : _game->getSavedGame()->getAlienMissions())
 	{
@@ -1835,9 +1971,10 @@ void GeoscapeState::time30Minutes()
 				}
 				else
 				{
-					if (base->getStorageItems()->getItem(item) > 0)
+					const RuleItem *refuelItem = _game->getMod()->getItem(item, true);
+					if (base->getStorageItems()->getItem(refuelItem) > 0)
 					{
-						base->getStorageItems()->removeItem(item);
+						base->getStorageItems()->removeItem(refuelItem);
 						craft->refuel();
 						craft->setLowFuel(false);
 						// notification
@@ -2031,6 +2168,7 @@ void GeoscapeState::time30Minutes()
  */
 void GeoscapeState::time1Hour()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_1HOUR);
 	// Handle craft maintenance
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
@@ -2106,10 +2244,9 @@ void GeoscapeState::time1Hour()
 			{
 				_game->getSavedGame()->setAlienContainmentChecked(true);
 				std::map<int, int> prisonTypes;
-				RuleItem *rule = nullptr;
-				for (auto &item : *(*i)->getStorageItems()->getContents())
+				for (auto &item : *(*i)->getStorageItems())
 				{
-					rule = _game->getMod()->getItem(item.first, true);
+					const RuleItem *rule = item.first;
 					if (rule->isAlien())
 					{
 						prisonTypes[rule->getPrisonType()] += 1;
@@ -2239,6 +2376,7 @@ void GenerateSupplyMission::operator()(AlienBase *base) const
  */
 void GeoscapeState::time1Day()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_1DAY);
 	SavedGame *saveGame = _game->getSavedGame();
 	Mod *mod = _game->getMod();
 	bool psiStrengthEval = (Options::psiStrengthEval && saveGame->isResearched(mod->getPsiRequirements()));
@@ -2306,7 +2444,7 @@ void GeoscapeState::time1Day()
 					auto ruleCorpse = ruleUnit->getArmor()->getCorpseGeoscape();
 					if (ruleCorpse && ruleCorpse->isRecoverable() && ruleCorpse->isCorpseRecoverable())
 					{
-						base->getStorageItems()->addItem(ruleCorpse->getType());
+						base->getStorageItems()->addItem(ruleCorpse);
 					}
 				}
 			}
@@ -2314,7 +2452,7 @@ void GeoscapeState::time1Day()
 			if (spawnedItem)
 			{
 				Transfer *t = new Transfer(1);
-				t->setItems(research->getSpawnedItem());
+				t->setItems(spawnedItem);
 				base->getTransfers()->push_back(t);
 			}
 			RuleEvent* spawnedEventRule = _game->getMod()->getEvent(research->getSpawnedEvent());
@@ -2691,6 +2829,7 @@ void GeoscapeState::time1Day()
  */
 void GeoscapeState::time1Month()
 {
+	Profiler::Scope profile(PROF_GEO_TIME_1MONTH);
 	_game->getSavedGame()->addMonth();
 
 	// Determine alien mission for this month.
@@ -3339,6 +3478,7 @@ void GeoscapeState::handleBaseDefense(Base *base, Ufo *ufo)
  */
 void GeoscapeState::determineAlienMissions()
 {
+	Profiler::Scope profile(PROF_GEO_ALIEN_MISSIONS);
 	SavedGame *save = _game->getSavedGame();
 	AlienStrategy &strategy = save->getAlienStrategy();
 	Mod *mod = _game->getMod();
@@ -3387,7 +3527,7 @@ void GeoscapeState::determineAlienMissions()
 					// item requirements
 					for (auto &triggerItem : arcScript->getItemTriggers())
 					{
-						triggerHappy = (save->isItemObtained(triggerItem.first) == triggerItem.second);
+						triggerHappy = (save->isItemObtained(triggerItem.first, mod) == triggerItem.second);
 						if (!triggerHappy)
 							break;
 					}
@@ -3510,7 +3650,7 @@ void GeoscapeState::determineAlienMissions()
 				// item requirements
 				for (auto &triggerItem : command->getItemTriggers())
 				{
-					triggerHappy = (save->isItemObtained(triggerItem.first) == triggerItem.second);
+					triggerHappy = (save->isItemObtained(triggerItem.first, mod) == triggerItem.second);
 					if (!triggerHappy)
 						break;
 				}
@@ -3611,7 +3751,7 @@ void GeoscapeState::determineAlienMissions()
 					// item requirements
 					for (auto &triggerItem : eventScript->getItemTriggers())
 					{
-						triggerHappy = (save->isItemObtained(triggerItem.first) == triggerItem.second);
+						triggerHappy = (save->isItemObtained(triggerItem.first, mod) == triggerItem.second);
 						if (!triggerHappy)
 							break;
 					}
@@ -43,6 +43,7 @@ class RuleMissionScript;
  */
 class GeoscapeState : public State
 {
+	friend class GeoscapeBenchmark;
 private:
 	Surface *_bg, *_sideLine, *_sidebar;
 	Globe *_globe;
@@ -84,8 +85,14 @@ public:
 	void timeDisplay();
 	/// Advances the game timer.
 	void timeAdvance();
+	/// Advances the game time by a number of 5 second steps.
+	int runTimeSteps(int timeSpan);
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
+	/// Gets how many 5 second steps can be skipped without missing anything.
+	int getQuietSteps(int maxSteps) const;
+	/// Skips several quiet 5 second steps at once.
+	void skipQuietSteps(int steps);
 	/// Trigger whenever 10 minutes pass.
 	void time10Minutes();
 	void ufoHuntingAndEscorting();
@@ -246,17 +246,30 @@ struct CreateShadow
 		temp.z *= temp.z;
 		temp.x += temp.z + temp.y;
 		//we have norm of distance between 2 vectors, now stored in `x`
+		return getShadowValue(temp.x, noise);
+	}
+
+	static inline Uint8 getShadowValue(const CordFloat& earth, const CordFloat& sun, const Sint16& noise)
+	{
+		//same as above, only the squared distance is computed in single precision
+		const float x = earth.x - sun.x;
+		const float y = earth.y - sun.y;
+		const float z = earth.z - sun.z;
+		return getShadowValue(x * x + y * y + z * z, noise);
+	}
 
-		temp.x -= 2;
-		temp.x *= 125.;
-		temp.x += GlobeStaticData::shade_gradient_max / 2;
+	static inline Uint8 getShadowValue(double distance, const Sint16& noise)
+	{
+		distance -= 2;
+		distance *= 125.;
+		distance += GlobeStaticData::shade_gradient_max / 2;
 		//random noise that go in any direction
-		temp.x -= static_data.getDistanceNoise(noise);
+		distance -= static_data.getDistanceNoise(noise);
 		//random noise than increase with distance from middle of twilight
-		temp.x += static_data.getMultiplierNoise(noise) * 4 * (temp.x - GlobeStaticData::shade_gradient_max / 2) / GlobeStaticData::shade_gradient_max;
+		distance += static_data.getMultiplierNoise(noise) * 4 * (distance - GlobeStaticData::shade_gradient_max / 2) / GlobeStaticData::shade_gradient_max;
 
 		double full = 0;
-		double rem = std::modf(temp.x, &full);
+		double rem = std::modf(distance, &full);
 		int offset = Clamp((int)full, 0, GlobeStaticData::shade_gradient_max - 1);
 		int i = static_data.shade_gradient[offset];
 
@@ -288,7 +301,7 @@ struct CreateShadow
 		return Globe::OCEAN_SHADING && dest >= Globe::OCEAN_COLOR && dest < Globe::OCEAN_COLOR + 32;
 	}
 
-	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	static inline void func(Uint8& dest, const CordFloat& earth, const CordFloat& sun, const Sint16& noise)
 	{
 		if (dest && earth.z)
 		{
@@ -351,6 +364,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	setupRadii(width, height);
 	setZoom(_zoom);
 
+	loadLandPoints();
 	cachePolygons();
 }
 
@@ -366,11 +380,6 @@ Globe::~Globe()
 	delete _texture;
 	delete _radars;
 	delete _clipper;
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
-	{
-		delete *i;
-	}
 }
 
 /**
@@ -445,48 +454,15 @@ bool Globe::pointBack(double lon, double lat) const
 	return c < 0.0;
 }
 
+/**
+ * Gets the land polygon at a polar point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the polygon, or NULL over water.
+ */
 Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 {
-	const double zDiscard=0.75f;
-	double coslat = cos(lat);
-	double sinlat = sin(lat);
-
-	for (std::list<Polygon*>::iterator i = _rules->getPolygons()->begin(); i != _rules->getPolygons()->end(); ++i)
-	{
-		double x, y, z, x2, y2;
-		double clat, clon;
-		z = 0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			z = coslat * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - lon) + sinlat * sin((*i)->getLatitude(j));
-			if (z<zDiscard) break; //discarded
-		}
-		if (z<zDiscard) continue; //discarded
-
-		bool odd = false;
-
-		clat = (*i)->getLatitude(0); //initial point
-		clon = (*i)->getLongitude(0);
-		x = cos(clat) * sin(clon - lon);
-		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			int k = (j + 1) % (*i)->getPoints(); //index of next point in poly
-			clat = (*i)->getLatitude(k);
-			clon = (*i)->getLongitude(k);
-
-			x2 = cos(clat) * sin(clon - lon);
-			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
-				odd = !odd;
-			x = x2;
-			y = y2;
-
-		}
-		if (odd) return *i;
-	}
-	return NULL;
+	return _rules->getPolygonAt(lon, lat);
 }
 
 /**
@@ -831,6 +807,40 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft, Craft *currentC
 	return v;
 }
 
+/**
+ * Converts the points of all the land polygons to cartesian
+ * coordinates on the unit sphere, stored as flat arrays, so
+ * projecting them for a new view is only a rotation and scale.
+ */
+void Globe::loadLandPoints()
+{
+	std::list<Polygon*> *polygons = _rules->getPolygons();
+	_landX.clear();
+	_landY.clear();
+	_landZ.clear();
+	_landStart.clear();
+	_landTexture.clear();
+	for (std::list<Polygon*>::const_iterator i = polygons->begin(); i != polygons->end(); ++i)
+	{
+		_landStart.push_back(_landX.size());
+		_landTexture.push_back((*i)->getTexture());
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			double lon = (*i)->getLongitude(j);
+			double lat = (*i)->getLatitude(j);
+			_landX.push_back(cos(lat) * cos(lon));
+			_landY.push_back(cos(lat) * sin(lon));
+			_landZ.push_back(sin(lat));
+		}
+	}
+	_landStart.push_back(_landX.size());
+
+	_cacheX.resize(_landX.size());
+	_cacheY.resize(_landX.size());
+	_cacheZ.resize(_landX.size());
+	_cacheLand.reserve(polygons->size());
+}
+
 /**
  * Takes care of pre-calculating all the polygons currently visible
  * on the globe and caching them so they only need to be recalculated
@@ -838,33 +848,34 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft, Craft *currentC
  */
 void Globe::cachePolygons()
 {
-	cache(_rules->getPolygons(), &_cacheLand);
-}
+	// Orthographic projection, same as polarToCart but with the
+	// trigonometry of the points already done by loadLandPoints
+	const double cosLon = cos(_cenLon), sinLon = sin(_cenLon);
+	const double cosLat = cos(_cenLat), sinLat = sin(_cenLat);
+	const double xx = -sinLon * _radius, xy = cosLon * _radius;
+	const double yx = -sinLat * cosLon * _radius, yy = -sinLat * sinLon * _radius, yz = cosLat * _radius;
+	const double zx = cosLat * cosLon, zy = cosLat * sinLon, zz = sinLat;
 
-/**
- * Caches a set of polygons.
- * @param polygons Pointer to list of polygons.
- * @param cache Pointer to cache.
- */
-void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
-{
-	// Clear existing cache
-	for (std::list<Polygon*>::iterator i = cache->begin(); i != cache->end(); ++i)
+	const size_t points = _landX.size();
+	const double *landX = _landX.data(), *landY = _landY.data(), *landZ = _landZ.data();
+	Sint16 *cacheX = _cacheX.data(), *cacheY = _cacheY.data();
+	double *cacheZ = _cacheZ.data();
+	for (size_t j = 0; j < points; ++j)
 	{
-		delete *i;
+		cacheX[j] = _cenX + (Sint16)floor(xx * landX[j] + xy * landY[j]);
+		cacheY[j] = _cenY + (Sint16)floor(yx * landX[j] + yy * landY[j] + yz * landZ[j]);
+		cacheZ[j] = zx * landX[j] + zy * landY[j] + zz * landZ[j];
 	}
-	cache->clear();
 
-	// Pre-calculate values to cache
-	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
+	_cacheLand.clear();
+	for (size_t i = 0; i + 1 < _landStart.size(); ++i)
 	{
 		// Is quad on the back face?
 		double closest = 0.0;
-		double z;
 		double furthest = 0.0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
+		for (int j = _landStart[i]; j < _landStart[i + 1]; ++j)
 		{
-			z = cos(_cenLat) * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - _cenLon) + sin(_cenLat) * sin((*i)->getLatitude(j));
+			double z = cacheZ[j];
 			if (z > closest)
 				closest = z;
 			else if (z < furthest)
@@ -873,18 +884,7 @@ void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
 		if (-furthest > closest)
 			continue;
 
-		Polygon* p = new Polygon(**i);
-
-		// Convert coordinates
-		for (int j = 0; j < p->getPoints(); ++j)
-		{
-			Sint16 x, y;
-			polarToCart(p->getLongitude(j), p->getLatitude(j), &x, &y);
-			p->setX(j, x);
-			p->setY(j, y);
-		}
-
-		cache->push_back(p);
+		_cacheLand.push_back(i);
 	}
 }
 
@@ -978,19 +978,12 @@ void Globe::drawOcean()
  */
 void Globe::drawLand()
 {
-	Sint16 x[4], y[4];
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
+	for (std::vector<int>::const_iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
 	{
-		// Convert coordinates
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			x[j] = (*i)->getX(j);
-			y[j] = (*i)->getY(j);
-		}
+		int first = _landStart[*i];
 
 		// Apply textures according to zoom and shade
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + _zoomTexture), 0, 0);
+		drawTexturedPolygon(&_cacheX[first], &_cacheY[first], _landStart[*i + 1] - first, _texture->getFrame(_landTexture[*i] + _zoomTexture), 0, 0);
 	}
 }
 
@@ -1052,13 +1045,13 @@ Cord Globe::getSunDirection(double lon, double lat) const
 
 void Globe::drawShadow()
 {
-	auto earth = ShaderMove<Cord>(SurfaceRaw<Cord>(_earthData[_zoom], getWidth(), getHeight()));
+	auto earth = ShaderMove<CordFloat>(SurfaceRaw<CordFloat>(_earthData[_zoom], getWidth(), getHeight()));
 	auto noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
 
 	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
 
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	ShaderDrawParallel<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(CordFloat(getSunDirection(_cenLon, _cenLat))), noise);
 	unlock();
 
 }
@@ -2087,7 +2080,7 @@ void Globe::setupRadii(int width, int height)
 		for (int j=0; j<height; ++j)
 			for (int i=0; i<width; ++i)
 			{
-				_earthData[r][width*j + i] = static_data.circle_norm(width/2, height/2, _zoomRadius[r], i+.5, j+.5);
+				_earthData[r][width*j + i] = CordFloat(static_data.circle_norm(width/2, height/2, _zoomRadius[r], i+.5, j+.5));
 			}
 	}
 }
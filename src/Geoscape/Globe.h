@@ -64,11 +64,21 @@ private:
 	bool _hover, _craft;
 	int _blink;
 	Timer *_blinkTimer, *_rotTimer;
-	std::list<Polygon*> _cacheLand;
+	/// Points of all the land polygons on the unit sphere, one array per axis.
+	std::vector<double> _landX, _landY, _landZ;
+	/// Index of the first point of each land polygon, followed by the total.
+	std::vector<int> _landStart;
+	/// Texture of each land polygon.
+	std::vector<int> _landTexture;
+	/// Screen position and depth of every land point for the current view.
+	std::vector<Sint16> _cacheX, _cacheY;
+	std::vector<double> _cacheZ;
+	/// Land polygons facing the viewer.
+	std::vector<int> _cacheLand;
 	FastLineClip *_clipper;
 	double _radius, _radiusStep;
 	///normal of each pixel in earth globe per zoom level
-	std::vector<std::vector<Cord> > _earthData;
+	std::vector<std::vector<CordFloat> > _earthData;
 	///list of dimension of earth on screen per zoom level
 	std::vector<double> _zoomRadius;
 
@@ -87,8 +97,8 @@ private:
 	Polygon* getPolygonFromLonLat(double lon, double lat) const;
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
-	/// Caches a set of polygons.
-	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
+	/// Copies the land polygons onto the unit sphere.
+	void loadLandPoints();
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
 	/// Draw globe range circle.
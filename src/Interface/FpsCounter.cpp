@@ -34,7 +34,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0), _pixels(0)
 {
 	_visible = Options::fpsCounter;
 
@@ -42,7 +42,8 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 	_timer->onTimer((SurfaceHandler)&FpsCounter::update);
 	_timer->start();
 
-	_text = new NumberText(width, height, x, y);
+	_text = new NumberText(width, height / 2, x, y);
+	_pixelText = new NumberText(width, height / 2, x, y + height - height / 2);
 }
 
 /**
@@ -51,6 +52,7 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 FpsCounter::~FpsCounter()
 {
 	delete _text;
+	delete _pixelText;
 	delete _timer;
 }
 
@@ -64,6 +66,7 @@ void FpsCounter::setPalette(const SDL_Color *colors, int firstcolor, int ncolors
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
 	_text->setPalette(colors, firstcolor, ncolors);
+	_pixelText->setPalette(colors, firstcolor, ncolors);
 }
 
 /**
@@ -73,6 +76,7 @@ void FpsCounter::setPalette(const SDL_Color *colors, int firstcolor, int ncolors
 void FpsCounter::setColor(Uint8 color)
 {
 	_text->setColor(color);
+	_pixelText->setColor(color);
 }
 
 /**
@@ -103,7 +107,9 @@ void FpsCounter::update()
 {
 	int fps = (int)floor((double)_frames / _timer->getTime() * 1000);
 	_text->setValue(fps);
+	_pixelText->setValue(_frames ? _pixels / _frames : 0);
 	_frames = 0;
+	_pixels = 0;
 	_redraw = true;
 }
 
@@ -114,6 +120,7 @@ void FpsCounter::draw()
 {
 	Surface::draw();
 	_text->blit(this->getSurface());
+	_pixelText->blit(this->getSurface());
 }
 
 void FpsCounter::addFrame()
@@ -121,4 +128,13 @@ void FpsCounter::addFrame()
 	_frames++;
 }
 
+/**
+ * Adds up the screen pixels redrawn by the last frame.
+ * @param pixels Amount of pixels.
+ */
+void FpsCounter::addPixels(int pixels)
+{
+	_pixels += pixels;
+}
+
 }
@@ -28,14 +28,15 @@ class Action;
 
 /**
  * Counts the amount of frames each second
- * and displays them in a NumberText surface.
+ * and displays them in a NumberText surface,
+ * along with the screen pixels redrawn per frame.
  */
 class FpsCounter : public Surface
 {
 private:
-	NumberText *_text;
+	NumberText *_text, *_pixelText;
 	Timer *_timer;
-	int _frames;
+	int _frames, _pixels;
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -54,6 +55,8 @@ public:
 	/// Draws the FPS counter.
 	void draw() override;
 	void addFrame();
+	/// Adds the pixels redrawn by a frame.
+	void addPixels(int pixels);
 };
 
 }
@@ -301,14 +301,14 @@ void NewBattleState::load(const std::string &filename)
 				}
 
 				// Generate items
-				base->getStorageItems()->getContents()->clear();
+				base->getStorageItems()->clear();
 				const std::vector<std::string> &items = mod->getItemsList();
 				for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 				{
 					RuleItem *rule = _game->getMod()->getItem(*i);
 					if (rule->getBattleType() != BT_CORPSE && rule->isRecoverable())
 					{
-						base->getStorageItems()->addItem(*i, 1);
+						base->getStorageItems()->addItem(rule, 1);
 					}
 				}
 
@@ -321,15 +321,8 @@ void NewBattleState::load(const std::string &filename)
 				}
 				else
 				{
+					// unknown items were already dropped when the craft was loaded
 					_craft = base->getCrafts()->front();
-					for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
-					{
-						RuleItem *rule = _game->getMod()->getItem(i->first);
-						if (!rule)
-						{
-							i->second = 0;
-						}
-					}
 				}
 
 				_game->setSavedGame(save);
@@ -391,7 +384,7 @@ void NewBattleState::initSave()
 	base->getSoldiers()->clear();
 	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
 	base->getCrafts()->clear();
-	base->getStorageItems()->getContents()->clear();
+	base->getStorageItems()->clear();
 
 	_craft = new Craft(mod->getCraft(_crafts[_cbxCraft->getSelected()]), base, 1);
 	base->getCrafts()->push_back(_craft);
@@ -442,10 +435,10 @@ void NewBattleState::initSave()
 		if (rule->getBattleType() != BT_CORPSE && rule->isRecoverable())
 		{
 			int howMany = rule->getBattleType() == BT_AMMO ? 2 : 1;
-			base->getStorageItems()->addItem(*i, howMany);
+			base->getStorageItems()->addItem(rule, howMany);
 			if (rule->getBattleType() != BT_NONE && rule->isInventoryItem())
 			{
-				_craft->getItems()->addItem(*i, howMany);
+				_craft->getItems()->addItem(rule, howMany);
 			}
 		}
 	}
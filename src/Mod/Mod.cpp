@@ -1571,6 +1571,19 @@ static void afterLoadHelper(const char* name, Mod* mod, std::map<std::string, T*
 	}
 }
 
+/**
+ * Gives all rules of one type dense indexes, in name order.
+ */
+template <typename T>
+static void assignIndexHelper(std::map<std::string, T*>& list)
+{
+	int index = 0;
+	for (auto& rule : list)
+	{
+		rule.second->setIndex(index++);
+	}
+}
+
 /**
  * Helper function used to disable invalid mod and throw exception to quit game
  * @param modId Mod id
@@ -1751,6 +1764,10 @@ void Mod::loadAll()
 	afterLoadHelper("skills", this, _skills, &RuleSkill::afterLoad);
 	afterLoadHelper("craftWeapons", this, _craftWeapons, &RuleCraftWeapon::afterLoad);
 
+	// dense ids, used by the research state of saved games and by item containers
+	assignIndexHelper(_research);
+	assignIndexHelper(_items);
+
 	for (auto& a : _armors)
 	{
 		if (a.second->hasInfiniteSupply())
@@ -1870,6 +1887,7 @@ void Mod::loadAll()
 	sortLists();
 	loadExtraResources();
 	modResources();
+	_globe->buildPolygonGrid();
 }
 
 /**
@@ -210,4 +210,50 @@ int Polygon::getPoints() const
 	return _points;
 }
 
+/**
+ * Checks if a point on the globe is inside the polygon. The polygon
+ * is discarded if any of its points is too far away from the point,
+ * otherwise a ray is cast in a projection centered on the point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return True if the point is inside.
+ */
+bool Polygon::containsPoint(double lon, double lat) const
+{
+	const double zDiscard=0.75f;
+	double coslat = cos(lat);
+	double sinlat = sin(lat);
+
+	double x, y, z, x2, y2;
+	double clat, clon;
+	z = 0;
+	for (int j = 0; j < _points; ++j)
+	{
+		z = coslat * cos(_lat[j]) * cos(_lon[j] - lon) + sinlat * sin(_lat[j]);
+		if (z<zDiscard) return false; //discarded
+	}
+
+	bool odd = false;
+
+	clat = _lat[0]; //initial point
+	clon = _lon[0];
+	x = cos(clat) * sin(clon - lon);
+	y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+
+	for (int j = 0; j < _points; ++j)
+	{
+		int k = (j + 1) % _points; //index of next point in poly
+		clat = _lat[k];
+		clon = _lon[k];
+
+		x2 = cos(clat) * sin(clon - lon);
+		y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+		if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
+			odd = !odd;
+		x = x2;
+		y = y2;
+	}
+	return odd;
+}
+
 }
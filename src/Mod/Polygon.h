@@ -65,6 +65,8 @@ public:
 	void setTexture(int tex);
 	/// Gets the number of points of the polygon.
 	int getPoints() const;
+	/// Checks if a point on the globe is inside the polygon.
+	bool containsPoint(double lon, double lat) const;
 };
 
 }
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleGlobe.h"
+#include <algorithm>
+#include <cmath>
 #include <SDL_endian.h>
 #include "../Engine/Exception.h"
 #include "Polygon.h"
@@ -30,6 +32,47 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Columns of the polygon grid, each covering 2 degrees of longitude.
+const int PolygonGridLon = 180;
+/// Rows of the polygon grid, each covering 2 degrees of latitude.
+const int PolygonGridLat = 90;
+
+/**
+ * Unit vector of a point on the globe.
+ */
+struct GlobeVector
+{
+	double x, y, z;
+
+	GlobeVector(double lon, double lat) : x(cos(lat) * cos(lon)), y(cos(lat) * sin(lon)), z(sin(lat)) { }
+
+	double dot(const GlobeVector &other) const { return x * other.x + y * other.y + z * other.z; }
+	double angle(const GlobeVector &other) const { return acos(Clamp(dot(other), -1.0, 1.0)); }
+};
+
+/**
+ * Gets the grid cell a point falls in.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Index of the cell.
+ */
+int getPolygonGridCell(double lon, double lat)
+{
+	lon = fmod(lon, 2 * M_PI);
+	if (lon < 0)
+	{
+		lon += 2 * M_PI;
+	}
+	int column = Clamp((int)(lon / (2 * M_PI) * PolygonGridLon), 0, PolygonGridLon - 1);
+	int row = Clamp((int)((lat + M_PI_2) / M_PI * PolygonGridLat), 0, PolygonGridLat - 1);
+	return row * PolygonGridLon + column;
+}
+
+}
+
 /**
  * Creates a blank ruleset for globe contents.
  */
@@ -148,6 +191,106 @@ std::list<Polygon*> *RuleGlobe::getPolygons()
 	return &_polygons;
 }
 
+/**
+ * Sorts the polygons into a latitude/longitude grid, so finding the polygon
+ * at a point only tests the few polygons listed in its cell, in the same order
+ * as the full list. A polygon can only contain points inside the smallest cap
+ * around the centre of its points that holds all of them, so it is listed in
+ * every cell that touches that cap.
+ * Needs to be called again after the polygons change.
+ */
+void RuleGlobe::buildPolygonGrid()
+{
+	const double cellLon = 2 * M_PI / PolygonGridLon;
+	const double cellLat = M_PI / PolygonGridLat;
+	std::vector<std::vector<Polygon*> > cells(PolygonGridLon * PolygonGridLat);
+
+	for (std::list<Polygon*>::iterator i = _polygons.begin(); i != _polygons.end(); ++i)
+	{
+		Polygon *polygon = *i;
+		if (polygon->getPoints() == 0)
+		{
+			continue;
+		}
+
+		// cap around the average direction of the points
+		double x = 0, y = 0, z = 0;
+		for (int j = 0; j < polygon->getPoints(); ++j)
+		{
+			GlobeVector point(polygon->getLongitude(j), polygon->getLatitude(j));
+			x += point.x;
+			y += point.y;
+			z += point.z;
+		}
+		double length = sqrt(x * x + y * y + z * z);
+		bool everywhere = length < 1e-9;
+		GlobeVector center(atan2(y, x), everywhere ? 0.0 : asin(Clamp(z / length, -1.0, 1.0)));
+		double radius = 0;
+		for (int j = 0; j < polygon->getPoints(); ++j)
+		{
+			radius = std::max(radius, center.angle(GlobeVector(polygon->getLongitude(j), polygon->getLatitude(j))));
+		}
+		// caps this big can't pass the distance check of Polygon::containsPoint anyway, keep them simple
+		everywhere = everywhere || radius > M_PI_2;
+
+		for (int row = 0; row < PolygonGridLat; ++row)
+		{
+			double latMin = -M_PI_2 + row * cellLat;
+			// all the cells of a row have the same size, the farthest points from the middle are the corners
+			GlobeVector middle(cellLon / 2, latMin + cellLat / 2);
+			double cellRadius = std::max(middle.angle(GlobeVector(0, latMin)), middle.angle(GlobeVector(0, latMin + cellLat)));
+			double minDot = cos(std::min(M_PI, radius + cellRadius + 1e-6));
+			for (int column = 0; column < PolygonGridLon; ++column)
+			{
+				if (everywhere || center.dot(GlobeVector((column + 0.5) * cellLon, latMin + cellLat / 2)) >= minDot)
+				{
+					cells[row * PolygonGridLon + column].push_back(polygon);
+				}
+			}
+		}
+	}
+
+	_polygonGridStart.clear();
+	_polygonGrid.clear();
+	for (std::vector<std::vector<Polygon*> >::const_iterator i = cells.begin(); i != cells.end(); ++i)
+	{
+		_polygonGridStart.push_back(_polygonGrid.size());
+		_polygonGrid.insert(_polygonGrid.end(), i->begin(), i->end());
+	}
+	_polygonGridStart.push_back(_polygonGrid.size());
+}
+
+/**
+ * Gets the first polygon in the list that contains a point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @param useGrid Only test the polygons in the grid cell of the point, if the grid was built.
+ * @return Pointer to the polygon, or NULL over water.
+ */
+Polygon *RuleGlobe::getPolygonAt(double lon, double lat, bool useGrid) const
+{
+	if (useGrid && !_polygonGridStart.empty())
+	{
+		int cell = getPolygonGridCell(lon, lat);
+		for (int i = _polygonGridStart[cell]; i < _polygonGridStart[cell + 1]; ++i)
+		{
+			if (_polygonGrid[i]->containsPoint(lon, lat))
+			{
+				return _polygonGrid[i];
+			}
+		}
+		return NULL;
+	}
+	for (std::list<Polygon*>::const_iterator i = _polygons.begin(); i != _polygons.end(); ++i)
+	{
+		if ((*i)->containsPoint(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return NULL;
+}
+
 /**
  * Returns the list of polylines in the globe.
  * @return Pointer to the list of polylines.
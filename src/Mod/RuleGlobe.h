@@ -19,6 +19,7 @@
  */
 #include <list>
 #include <string>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -39,6 +40,8 @@ private:
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+	std::vector<int> _polygonGridStart;
+	std::vector<Polygon*> _polygonGrid;
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -52,6 +55,10 @@ public:
 	std::list<Polyline*> *getPolylines();
 	/// Loads a set of polygons from a DAT file.
 	void loadDat(const std::string &filename);
+	/// Builds the grid used to find the polygon at a point.
+	void buildPolygonGrid();
+	/// Gets the polygon containing a point.
+	Polygon *getPolygonAt(double lon, double lat, bool useGrid = true) const;
 	/// Gets a specific world texture.
 	Texture *getTexture(int id) const;
 	/// Gets all the terrains for a specific deployment.
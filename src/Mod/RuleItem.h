@@ -357,7 +357,7 @@ private:
 	bool _arcingShot;
 	ExperienceTrainingMode _experienceTrainingMode;
 	int _manaExperience;
-	int _listOrder, _maxRange, _minRange, _dropoff, _bulletSpeed, _explosionSpeed, _shotgunPellets;
+	int _listOrder, _index, _maxRange, _minRange, _dropoff, _bulletSpeed, _explosionSpeed, _shotgunPellets;
 	int _shotgunBehaviorType, _shotgunSpread, _shotgunChoke;
 	std::map<std::string, std::string> _zombieUnitByArmorMale, _zombieUnitByArmorFemale, _zombieUnitByType;
 	std::string _zombieUnit, _spawnUnit;
@@ -764,6 +764,10 @@ public:
 	int getAttraction() const;
 	/// Get the list weight for this item.
 	int getListOrder() const;
+	/// Gets the dense index of this item, in type order.
+	int getIndex() const { return _index; }
+	/// Sets the dense index of this item.
+	void setIndex(int index) { _index = index; }
 	/// How fast does a projectile fired from this weapon travel?
 	int getBulletSpeed() const;
 	/// How fast does the explosion animation play?
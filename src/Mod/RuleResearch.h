@@ -51,7 +51,7 @@ class RuleResearch
 	std::map<std::string, std::vector<std::string> > _getOneFreeProtectedName;
 	std::map<const RuleResearch*, std::vector<const RuleResearch*> > _getOneFreeProtected;
 	bool _needItem, _destroyItem;
-	int _listOrder;
+	int _listOrder, _index;
 public:
 	static const int RESEARCH_STATUS_NEW = 0;
 	static const int RESEARCH_STATUS_NORMAL = 1;
@@ -93,6 +93,10 @@ public:
 	RuleBaseFacilityFunctions getRequireBaseFunc() const { return _requiresBaseFunc; }
 	/// Gets the list weight for this research item.
 	int getListOrder() const;
+	/// Gets the dense index of this research, in name order.
+	int getIndex() const { return _index; }
+	/// Sets the dense index of this research.
+	void setIndex(int index) { _index = index; }
 	/// Gets the cutscene to play when this item is researched
 	const std::string & getCutscene() const;
 	/// Gets the item to spawn in the base stores when this topic is researched.
@@ -54,7 +54,8 @@ namespace OpenXcom
  * Initializes an empty base.
  * @param mod Pointer to mod.
  */
-Base::Base(const Mod *mod) : Target(), _mod(mod), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false), _fakeUnderwater(false)
+Base::Base(const Mod *mod) : Target(), _mod(mod), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false), _fakeUnderwater(false),
+	_capacitiesValid(false), _storedAliensRevision(0)
 {
 	_items = new ItemContainer();
 }
@@ -113,6 +114,7 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 				BaseFacility *f = new BaseFacility(_mod->getBaseFacility(type), this);
 				f->load(*i);
 				_facilities.push_back(f);
+				invalidateCapacities();
 			}
 			else
 			{
@@ -164,20 +166,8 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 		}
 	}
 
-	_items->load(node["items"]);
-	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
-	{
-		if (_mod->getItem(i->first) == 0)
-		{
-			Log(LOG_ERROR) << "Failed to load item " << i->first;
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
-		}
-	}
+	// Some old saves have bad items, they are dropped to avoid further bugs
+	_items->load(node["items"], _mod);
 
 	_scientists = node["scientists"].as<int>(_scientists);
 	_engineers = node["engineers"].as<int>(_engineers);
@@ -665,7 +655,7 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 	{
 		if (transfer->getType() == TRANSFER_ITEM)
 		{
-			auto ruleItem = _mod->getItem(transfer->getItems(), true);
+			auto ruleItem = transfer->getItems();
 			if (ruleItem->getMonthlySalary() != 0)
 			{
 				staffCount += transfer->getQuantity();
@@ -678,9 +668,9 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 			}
 		}
 	}
-	for (const auto& storeItem : *_items->getContents())
+	for (const auto& storeItem : *_items)
 	{
-		auto ruleItem = _mod->getItem(storeItem.first, true);
+		auto ruleItem = storeItem.first;
 		if (ruleItem->getMonthlySalary() != 0)
 		{
 			staffCount += storeItem.second;
@@ -694,9 +684,9 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 	}
 	for (auto craft : _crafts)
 	{
-		for (const auto &craftItem : *craft->getItems()->getContents())
+		for (const auto &craftItem : *craft->getItems())
 		{
-			auto ruleItem = _mod->getItem(craftItem.first, true);
+			auto ruleItem = craftItem.first;
 			if (ruleItem->getMonthlySalary() != 0)
 			{
 				staffCount += craftItem.second;
@@ -741,6 +731,80 @@ int Base::getTotalOtherStaffAndInventoryCost(int& staffCount, int& inventoryCoun
 	return totalCost;
 }
 
+/**
+ * Counts the aliens in the stores for all prison types at once.
+ * @param storedAliens Amount of aliens by prison type to fill.
+ */
+void Base::calculateStoredAliens(std::map<int, int> &storedAliens) const
+{
+	storedAliens.clear();
+	for (const auto& i : *_items)
+	{
+		if (i.first->isAlien())
+		{
+			storedAliens[i.first->getPrisonType()] += i.second;
+		}
+	}
+}
+
+/**
+ * Sums up the capacities provided by all finished facilities.
+ * @param capacities Capacities to fill.
+ */
+void Base::calculateCapacities(BaseFacilityCapacities &capacities) const
+{
+	capacities = BaseFacilityCapacities();
+	for (const auto* fac : _facilities)
+	{
+		if (fac->getBuildTime() == 0)
+		{
+			const RuleBaseFacility *rule = fac->getRules();
+			capacities.Quarters += rule->getPersonnel();
+			capacities.Stores += rule->getStorage();
+			capacities.Laboratories += rule->getLaboratories();
+			capacities.Workshops += rule->getWorkshops();
+			capacities.Hangars += rule->getCrafts();
+			capacities.PsiLabs += rule->getPsiLaboratories();
+			capacities.Training += rule->getTrainingFacilities();
+			capacities.Containment[rule->getPrisonType()] += rule->getAliens();
+		}
+	}
+}
+
+/**
+ * Gets the capacities provided by all finished facilities.
+ * They are only summed up again after the facilities change,
+ * with the verification option on they are also checked
+ * against a fresh sum on every call.
+ * @return Facility capacities.
+ */
+const BaseFacilityCapacities &Base::getCapacities() const
+{
+	if (!_capacitiesValid)
+	{
+		calculateCapacities(_capacities);
+		_capacitiesValid = true;
+	}
+	else if (Options::oxceVerifyBaseCapacities)
+	{
+		BaseFacilityCapacities fresh;
+		calculateCapacities(fresh);
+		if (fresh.Quarters != _capacities.Quarters ||
+			fresh.Stores != _capacities.Stores ||
+			fresh.Laboratories != _capacities.Laboratories ||
+			fresh.Workshops != _capacities.Workshops ||
+			fresh.Hangars != _capacities.Hangars ||
+			fresh.PsiLabs != _capacities.PsiLabs ||
+			fresh.Training != _capacities.Training ||
+			fresh.Containment != _capacities.Containment)
+		{
+			Log(LOG_ERROR) << "Cached facility capacities of base " << _name << " are out of date.";
+			_capacities = fresh;
+		}
+	}
+	return _capacities;
+}
+
 /**
  * Returns the amount of living quarters used up
  * by personnel in the base.
@@ -767,15 +831,7 @@ int Base::getUsedQuarters() const
  */
 int Base::getAvailableQuarters() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPersonnel();
-		}
-	}
-	return total;
+	return getCapacities().Quarters;
 }
 
 /**
@@ -785,21 +841,21 @@ int Base::getAvailableQuarters() const
  */
 double Base::getUsedStores() const
 {
-	double total = _items->getTotalSize(_mod);
+	double total = _items->getTotalSize();
 	for (std::vector<Craft*>::const_iterator i = _crafts.begin(); i != _crafts.end(); ++i)
 	{
-		total += (*i)->getTotalItemStorageSize(_mod);
+		total += (*i)->getTotalItemStorageSize();
 	}
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
 	{
 		if ((*i)->getType() == TRANSFER_ITEM)
 		{
-			total += (*i)->getQuantity() * _mod->getItem((*i)->getItems(), true)->getSize();
+			total += (*i)->getQuantity() * (*i)->getItems()->getSize();
 		}
 		else if ((*i)->getType() == TRANSFER_CRAFT)
 		{
 			Craft *craft = (*i)->getCraft();
-			total += craft->getTotalItemStorageSize(_mod);
+			total += craft->getTotalItemStorageSize();
 		}
 	}
 	return total;
@@ -830,14 +886,14 @@ bool Base::storesOverfullCritical() const
 	double total = 0;
 	for (std::vector<Craft*>::const_iterator i = _crafts.begin(); i != _crafts.end(); ++i)
 	{
-		total += (*i)->getTotalItemStorageSize(_mod);
+		total += (*i)->getTotalItemStorageSize();
 	}
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
 	{
 		if ((*i)->getType() == TRANSFER_CRAFT)
 		{
 			Craft *craft = (*i)->getCraft();
-			total += craft->getTotalItemStorageSize(_mod);
+			total += craft->getTotalItemStorageSize();
 		}
 	}
 	int used = total * 100;
@@ -851,15 +907,7 @@ bool Base::storesOverfullCritical() const
  */
 int Base::getAvailableStores() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getStorage();
-		}
-	}
-	return total;
+	return getCapacities().Stores;
 }
 
 /**
@@ -887,15 +935,7 @@ int Base::getUsedLaboratories() const
  */
 int Base::getAvailableLaboratories() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getLaboratories();
-		}
-	}
-	return total;
+	return getCapacities().Laboratories;
 }
 
 /**
@@ -920,15 +960,7 @@ int Base::getUsedWorkshops() const
  */
 int Base::getAvailableWorkshops() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getWorkshops();
-		}
-	}
-	return total;
+	return getCapacities().Workshops;
 }
 
 /**
@@ -964,15 +996,7 @@ int Base::getUsedHangars() const
  */
 int Base::getAvailableHangars() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getCrafts();
-		}
-	}
-	return total;
+	return getCapacities().Hangars;
 }
 
 /**
@@ -1287,7 +1311,7 @@ void Base::removeResearch(ResearchProject * project)
 	{
 		if (ruleResearch->needItem() && ruleResearch->destroyItem())
 		{
-			getStorageItems()->addItem(ruleResearch->getName(), 1);
+			getStorageItems()->addItem(_mod->getItem(ruleResearch->getName()), 1);
 		}
 	}
 
@@ -1331,15 +1355,7 @@ const std::vector<Production *> & Base::getProductions() const
  */
 int Base::getAvailablePsiLabs() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPsiLaboratories();
-		}
-	}
-	return total;
+	return getCapacities().PsiLabs;
 }
 
 /**
@@ -1378,15 +1394,7 @@ int Base::getUsedPsiLabs() const
  */
 int Base::getAvailableTraining() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getTrainingFacilities();
-		}
-	}
-	return total;
+	return getCapacities().Training;
 }
 
 /**
@@ -1423,21 +1431,34 @@ int Base::getFreeTrainingSpace() const
  */
 int Base::getUsedContainment(int prisonType) const
 {
-	int total = 0;
-	RuleItem *rule = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	// aliens in the stores, counted again only after the stores change
+	if (_storedAliensRevision != _items->getRevision())
+	{
+		calculateStoredAliens(_storedAliens);
+		_storedAliensRevision = _items->getRevision();
+	}
+	else if (Options::oxceVerifyBaseCapacities)
 	{
-		rule = _mod->getItem((i)->first, true);
-		if (rule->isAlien() && rule->getPrisonType() == prisonType)
+		std::map<int, int> fresh;
+		calculateStoredAliens(fresh);
+		if (fresh != _storedAliens)
 		{
-			total += (i)->second;
+			Log(LOG_ERROR) << "Cached stored aliens of base " << _name << " are out of date.";
+			_storedAliens = fresh;
 		}
 	}
+	int total = 0;
+	std::map<int, int>::const_iterator stored = _storedAliens.find(prisonType);
+	if (stored != _storedAliens.end())
+	{
+		total += stored->second;
+	}
+	const RuleItem *rule = 0;
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
 	{
 		if ((*i)->getType() == TRANSFER_ITEM)
 		{
-			rule = _mod->getItem((*i)->getItems(), true);
+			rule = (*i)->getItems();
 			if (rule->isAlien() && rule->getPrisonType() == prisonType)
 			{
 				total += (*i)->getQuantity();
@@ -1466,15 +1487,9 @@ int Base::getUsedContainment(int prisonType) const
  */
 int Base::getAvailableContainment(int prisonType) const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0 && (*i)->getRules()->getPrisonType() == prisonType)
-		{
-			total += (*i)->getRules()->getAliens();
-		}
-	}
-	return total;
+	const std::map<int, int> &containment = getCapacities().Containment;
+	std::map<int, int>::const_iterator i = containment.find(prisonType);
+	return i != containment.end() ? i->second : 0;
 }
 
 /**
@@ -1577,11 +1592,11 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
+	for (ItemContainer::const_iterator i = _items->begin(); i != _items->end(); )
 	{
-		std::string itemId = (i)->first;
-		int itemQty = (i)->second;
-		RuleItem *rule = _mod->getItem(itemId, true);
+		int itemQty = i->second;
+		// vehicles need the non-const rule
+		RuleItem *rule = _mod->getItem(i->first->getType(), true);
 		if (rule->getVehicleUnit())
 		{
 			int size = rule->getVehicleUnit()->getArmor()->getTotalSize();
@@ -1593,7 +1608,7 @@ void Base::setupDefenses()
 					_vehicles.push_back(vehicle);
 					_vehiclesFromBase.push_back(vehicle);
 				}
-				_items->removeItem(itemId, itemQty);
+				_items->removeItem(rule, itemQty);
 			}
 			else // so this vehicle needs ammo
 			{
@@ -1614,10 +1629,10 @@ void Base::setupDefenses()
 					_vehiclesFromBase.push_back(vehicle);
 					_items->removeItem(ammo, ammoPerVehicle);
 				}
-				_items->removeItem(itemId, canBeAdded);
+				_items->removeItem(rule, canBeAdded);
 			}
 
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
+			i = _items->begin(); // we have to start over because the quantities changed
 		}
 		else ++i;
 	}
@@ -1695,6 +1710,7 @@ int Base::damageFacility(BaseFacility *toBeDamaged)
 		fac->setY(toBeDamaged->getY());
 		fac->setBuildTime(0);
 		_facilities.push_back(fac);
+		invalidateCapacities();
 
 		// move the craft from the original hangar to the damaged hangar
 		if (fac->getRules()->getCrafts() > 0)
@@ -1714,6 +1730,7 @@ int Base::damageFacility(BaseFacility *toBeDamaged)
 				fac->setY(toBeDamaged->getY() + y);
 				fac->setBuildTime(0);
 				_facilities.push_back(fac);
+				invalidateCapacities();
 			}
 		}
 	}
@@ -1857,12 +1874,11 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 			}
 
 			// remove all items
-			while (!(*facility)->getCraftForDrawing()->getItems()->getContents()->empty())
+			for (const auto& i : *(*facility)->getCraftForDrawing()->getItems())
 			{
-				std::map<std::string, int>::iterator i = (*facility)->getCraftForDrawing()->getItems()->getContents()->begin();
-				_items->addItem(i->first, i->second);
-				(*facility)->getCraftForDrawing()->getItems()->removeItem(i->first, i->second);
+				_items->addItem(i.first, i.second);
 			}
+			(*facility)->getCraftForDrawing()->getItems()->clear();
 			Collections::deleteIf(_crafts, 1,
 				[&](Craft* c)
 				{
@@ -2012,6 +2028,7 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 	_destroyedFacilitiesCache[(*facility)->getRules()] += 1;
 	delete *facility;
 	_facilities.erase(facility);
+	invalidateCapacities();
 }
 
 /**
@@ -2027,8 +2044,7 @@ void Base::cleanupDefenses(bool reclaimItems)
 		for (auto v : _vehiclesFromBase)
 		{
 			RuleItem *rule = v->getRules();
-			std::string type = rule->getType();
-			_items->addItem(type);
+			_items->addItem(rule);
 			if (rule->getVehicleClipAmmo())
 			{
 				_items->addItem(rule->getVehicleClipAmmo(), rule->getVehicleClipsLoaded());
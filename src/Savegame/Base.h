@@ -79,6 +79,26 @@ struct BaseSumDailyRecovery
 	float SickBayAbsoluteBonus = 0.0f;
 };
 
+struct BaseFacilityCapacities
+{
+	/// Living space.
+	int Quarters = 0;
+	/// Storage space.
+	int Stores = 0;
+	/// Laboratory space.
+	int Laboratories = 0;
+	/// Workshop space.
+	int Workshops = 0;
+	/// Number of hangars.
+	int Hangars = 0;
+	/// Psi laboratory space.
+	int PsiLabs = 0;
+	/// Training space.
+	int Training = 0;
+	/// Alien containment space per prison type.
+	std::map<int, int> Containment;
+};
+
 /**
  * Represents a player base on the globe.
  * Bases can contain facilities, personnel, crafts and equipment.
@@ -103,6 +123,17 @@ private:
 	std::vector<Vehicle*> _vehiclesFromBase;
 	std::vector<BaseFacility*> _defenses;
 	std::map<const RuleBaseFacility*, int> _destroyedFacilitiesCache;
+	mutable BaseFacilityCapacities _capacities;
+	mutable bool _capacitiesValid;
+	mutable std::map<int, int> _storedAliens;
+	mutable unsigned _storedAliensRevision;
+
+	/// Counts the aliens in the stores by prison type.
+	void calculateStoredAliens(std::map<int, int> &storedAliens) const;
+	/// Sums up the capacities of the finished facilities.
+	void calculateCapacities(BaseFacilityCapacities &capacities) const;
+	/// Gets the capacities of the finished facilities.
+	const BaseFacilityCapacities &getCapacities() const;
 
 	using Target::load;
 public:
@@ -126,6 +157,8 @@ public:
 	int getMarker() const override;
 	/// Gets the base's facilities.
 	std::vector<BaseFacility*> *getFacilities();
+	/// Marks the facility capacities as changed.
+	void invalidateCapacities() { _capacitiesValid = false; }
 	/// Gets the base's soldiers.
 	std::vector<Soldier*> *getSoldiers();
 	/// Pre-calculates soldier stats with various bonuses.
@@ -138,6 +171,8 @@ public:
 	std::vector<Transfer*> *getTransfers() { return &_transfers; }
 	/// Gets the base's transfers.
 	const std::vector<Transfer*> *getTransfers() const { return &_transfers; }
+	/// Gets the mod the base was created with.
+	const Mod *getMod() const { return _mod; }
 	/// Gets the base's items.
 	ItemContainer *getStorageItems() { return _items; }
 	/// Gets the base's items.
@@ -163,6 +163,7 @@ int BaseFacility::getAdjustedBuildTime() const
 void BaseFacility::setBuildTime(int time)
 {
 	_buildTime = time;
+	_base->invalidateCapacities();
 }
 
 /**
@@ -172,7 +173,10 @@ void BaseFacility::build()
 {
 	_buildTime--;
 	if (_buildTime == 0)
+	{
 		_hadPreviousFacility = false;
+		_base->invalidateCapacities();
+	}
 }
 
 /**
@@ -2065,6 +2065,28 @@ void BattleUnit::clearVisibleTiles()
 	_visibleTiles.clear();
 }
 
+/**
+ * Clears the visible tiles matching a condition. Also reduces the associated visibility counter used by the AI.
+ * @param remove Condition of tiles to remove.
+ */
+void BattleUnit::clearVisibleTiles(const std::function<bool(Tile*)> &remove)
+{
+	std::vector<Tile*>::iterator last = _visibleTiles.begin();
+	for (std::vector<Tile*>::iterator j = _visibleTiles.begin(); j != _visibleTiles.end(); ++j)
+	{
+		if (remove(*j))
+		{
+			(*j)->setVisible(-1);
+			_visibleTilesLookup.erase(*j);
+		}
+		else
+		{
+			*last++ = *j;
+		}
+	}
+	_visibleTiles.erase(last, _visibleTiles.end());
+}
+
 /**
  * Get accuracy of different types of psi attack.
  * @param actionType Psi attack type.
@@ -20,6 +20,7 @@
 #include <vector>
 #include <string>
 #include <unordered_set>
+#include <functional>
 #include "../Battlescape/Position.h"
 #include "../Mod/RuleItem.h"
 #include "Soldier.h"
@@ -350,6 +351,8 @@ public:
 	const std::vector<Tile*> *getVisibleTiles();
 	/// Clear visible tiles.
 	void clearVisibleTiles();
+	/// Clear visible tiles matching a condition.
+	void clearVisibleTiles(const std::function<bool(Tile*)> &remove);
 	/// Calculate psi attack accuracy.
 	static int getPsiAccuracy(BattleActionAttack::ReadOnly attack);
 	/// Calculate firing accuracy.
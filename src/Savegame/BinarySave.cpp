@@ -0,0 +1,408 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BinarySave.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+namespace BinarySave
+{
+
+namespace
+{
+
+/// Rest of the document start line separating the brief info from binary data.
+const char MARKER[] = " # binary save\n";
+const std::size_t MARKER_SIZE = sizeof(MARKER) - 1;
+/// Magic bytes at the start of binary data.
+const char MAGIC[] = "OXSB";
+const std::size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+/// Node types, with a flag for nodes carrying an explicit tag.
+enum NodeCode : Uint8 { NODE_NULL, NODE_SCALAR, NODE_SEQUENCE, NODE_MAP, NODE_TAGGED = 0x80 };
+
+/**
+ * Finds where the binary data starts.
+ * @param data File contents.
+ * @return Offset of the magic bytes, or 0 for text saves.
+ */
+std::size_t findBody(const std::string &data)
+{
+	std::size_t doc = data.find("\n---");
+	if (doc == std::string::npos)
+	{
+		return 0;
+	}
+	doc += 4;
+	if (data.compare(doc, MARKER_SIZE, MARKER) != 0)
+	{
+		return 0;
+	}
+	return doc + MARKER_SIZE;
+}
+
+/**
+ * Appends binary data to a buffer.
+ */
+class Writer
+{
+	std::vector<unsigned char> &_out;
+public:
+	Writer(std::vector<unsigned char> &out) : _out(out) { }
+
+	void writeRaw(const void *data, std::size_t size)
+	{
+		const unsigned char *p = static_cast<const unsigned char*>(data);
+		_out.insert(_out.end(), p, p + size);
+	}
+	void writeByte(Uint8 value)
+	{
+		_out.push_back(value);
+	}
+	void writeUint32(Uint32 value)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			_out.push_back((value >> (8 * i)) & 0xFF);
+		}
+	}
+	void writeSize(std::size_t value)
+	{
+		while (value >= 0x80)
+		{
+			_out.push_back((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		_out.push_back(value);
+	}
+	void writeString(const std::string &value)
+	{
+		writeSize(value.size());
+		writeRaw(value.data(), value.size());
+	}
+	void writeNode(const YAML::Node &node)
+	{
+		const std::string &tag = node.Tag();
+		// "?" and "!" are what the parser gives to plain and quoted values
+		bool tagged = !tag.empty() && tag != "?" && tag != "!";
+		Uint8 flag = tagged ? NODE_TAGGED : 0;
+		switch (node.Type())
+		{
+		case YAML::NodeType::Scalar:
+			writeByte(NODE_SCALAR | flag);
+			if (tagged) writeString(tag);
+			writeString(node.Scalar());
+			break;
+		case YAML::NodeType::Sequence:
+			writeByte(NODE_SEQUENCE | flag);
+			if (tagged) writeString(tag);
+			writeSize(node.size());
+			for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+			{
+				writeNode(*i);
+			}
+			break;
+		case YAML::NodeType::Map:
+			writeByte(NODE_MAP | flag);
+			if (tagged) writeString(tag);
+			writeSize(node.size());
+			for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+			{
+				writeNode(i->first);
+				writeNode(i->second);
+			}
+			break;
+		default:
+			writeByte(NODE_NULL);
+			break;
+		}
+	}
+	/// Writes a node prefixed by its size in bytes.
+	void writeSection(const YAML::Node &node)
+	{
+		std::size_t start = _out.size();
+		writeUint32(0);
+		writeNode(node);
+		Uint32 size = _out.size() - start - 4;
+		for (int i = 0; i < 4; ++i)
+		{
+			_out[start + i] = (size >> (8 * i)) & 0xFF;
+		}
+	}
+};
+
+/**
+ * Reads binary data from a buffer, throwing on any overrun.
+ */
+class Reader
+{
+	const unsigned char *_pos, *_end;
+
+	void check(std::size_t size) const
+	{
+		if (size > (std::size_t)(_end - _pos))
+		{
+			throw Exception("Binary save is truncated");
+		}
+	}
+public:
+	Reader(const unsigned char *begin, const unsigned char *end) : _pos(begin), _end(end) { }
+
+	const unsigned char *pos() const
+	{
+		return _pos;
+	}
+	bool atEnd() const
+	{
+		return _pos == _end;
+	}
+	Uint8 readByte()
+	{
+		check(1);
+		return *_pos++;
+	}
+	Uint32 readUint32()
+	{
+		check(4);
+		Uint32 value = _pos[0] | (_pos[1] << 8) | (_pos[2] << 16) | ((Uint32)_pos[3] << 24);
+		_pos += 4;
+		return value;
+	}
+	std::size_t readSize()
+	{
+		std::size_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			Uint8 b = readByte();
+			value |= (std::size_t)(b & 0x7F) << shift;
+			if (!(b & 0x80))
+			{
+				return value;
+			}
+		}
+		throw Exception("Binary save has an invalid size");
+	}
+	std::string readString()
+	{
+		std::size_t size = readSize();
+		check(size);
+		std::string value(reinterpret_cast<const char*>(_pos), size);
+		_pos += size;
+		return value;
+	}
+	YAML::Node readNode()
+	{
+		Uint8 code = readByte();
+		YAML::Node node;
+		std::string tag;
+		if (code & NODE_TAGGED)
+		{
+			tag = readString();
+		}
+		switch (code & ~NODE_TAGGED)
+		{
+		case NODE_NULL:
+			node = YAML::Node(YAML::NodeType::Null);
+			break;
+		case NODE_SCALAR:
+			node = YAML::Node(readString());
+			break;
+		case NODE_SEQUENCE:
+			{
+				node = YAML::Node(YAML::NodeType::Sequence);
+				std::size_t size = readSize();
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					node.push_back(readNode());
+				}
+			}
+			break;
+		case NODE_MAP:
+			{
+				node = YAML::Node(YAML::NodeType::Map);
+				std::size_t size = readSize();
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					YAML::Node key = readNode();
+					YAML::Node value = readNode();
+					// keys are unique already, skip the linear lookup of operator[]
+					node.force_insert(key, value);
+				}
+			}
+			break;
+		default:
+			throw Exception("Binary save has an invalid node type");
+		}
+		if (!tag.empty())
+		{
+			node.SetTag(tag);
+		}
+		return node;
+	}
+};
+
+}
+
+/**
+ * Checks if file contents are in the binary format.
+ * @param data File contents.
+ * @return True for binary saves.
+ */
+bool isBinary(const std::string &data)
+{
+	return findBody(data) != 0;
+}
+
+/**
+ * Builds the contents of a binary save file. The full save data
+ * must be a map, each of its keys gets its own section.
+ * @param brief Brief save info shown in the saves list.
+ * @param doc Full save data.
+ * @return File contents.
+ */
+std::vector<unsigned char> write(const YAML::Node &brief, const YAML::Node &doc)
+{
+	if (!doc.IsMap())
+	{
+		throw Exception("Binary save data must be a map");
+	}
+	YAML::Emitter header;
+	header << brief;
+
+	std::vector<unsigned char> out;
+	Writer w(out);
+	w.writeRaw(header.c_str(), header.size());
+	w.writeRaw("\n---", 4);
+	w.writeRaw(MARKER, MARKER_SIZE);
+	w.writeRaw(MAGIC, MAGIC_SIZE);
+	w.writeUint32(VERSION);
+	w.writeSize(doc.size());
+	for (YAML::const_iterator i = doc.begin(); i != doc.end(); ++i)
+	{
+		w.writeString(i->first.Scalar());
+		w.writeSection(i->second);
+	}
+	return out;
+}
+
+/**
+ * Builds the contents of a text save file.
+ * @param brief Brief save info shown in the saves list.
+ * @param doc Full save data.
+ * @return File contents.
+ */
+std::string writeText(const YAML::Node &brief, const YAML::Node &doc)
+{
+	YAML::Emitter out;
+	out << brief;
+	out << YAML::BeginDoc;
+	out << doc;
+	return out.c_str();
+}
+
+/**
+ * Reads the brief info and full save data from file contents.
+ * Text saves are parsed as YAML, binary ones are decoded section by section.
+ * @param data File contents.
+ * @return Brief info and full save data, same as YAML::LoadAll gives for text saves.
+ */
+std::vector<YAML::Node> read(const std::string &data)
+{
+	std::size_t body = findBody(data);
+	if (body == 0)
+	{
+		return YAML::LoadAll(data);
+	}
+
+	std::vector<YAML::Node> file;
+	file.push_back(YAML::Load(data.substr(0, body)));
+
+	const unsigned char *begin = reinterpret_cast<const unsigned char*>(data.data());
+	Reader r(begin + body, begin + data.size());
+	for (std::size_t i = 0; i < MAGIC_SIZE; ++i)
+	{
+		if (r.readByte() != (Uint8)MAGIC[i])
+		{
+			throw Exception("Binary save has an invalid signature");
+		}
+	}
+	Uint32 version = r.readUint32();
+	if (version > VERSION)
+	{
+		throw Exception("Binary save version " + std::to_string(version) + " is not supported");
+	}
+	YAML::Node doc(YAML::NodeType::Map);
+	std::size_t sections = r.readSize();
+	for (std::size_t i = 0; i < sections; ++i)
+	{
+		std::string key = r.readString();
+		Uint32 size = r.readUint32();
+		const unsigned char *start = r.pos();
+		YAML::Node value = r.readNode();
+		if ((Uint32)(r.pos() - start) != size)
+		{
+			throw Exception("Binary save section " + key + " is corrupted");
+		}
+		doc.force_insert(key, value);
+	}
+	if (!r.atEnd())
+	{
+		throw Exception("Binary save has trailing data");
+	}
+	file.push_back(doc);
+	return file;
+}
+
+/**
+ * Converts a save file between the text and binary formats, in place.
+ * @param filepath Full path to the save file.
+ * @param binary True to convert to binary, false to convert to text.
+ */
+void convert(const std::string &filepath, bool binary)
+{
+	std::string data = CrossPlatform::readFileRaw(filepath);
+	if (isBinary(data) == binary)
+	{
+		return;
+	}
+	std::vector<YAML::Node> file = read(data);
+	if (file.size() < 2)
+	{
+		throw Exception(filepath + " is not a valid save");
+	}
+	bool written;
+	if (binary)
+	{
+		written = CrossPlatform::writeFile(filepath, write(file[0], file[1]));
+	}
+	else
+	{
+		written = CrossPlatform::writeFile(filepath, writeText(file[0], file[1]));
+	}
+	if (!written)
+	{
+		throw Exception("Failed to save " + filepath);
+	}
+	Log(LOG_INFO) << "Converted " << filepath << " to " << (binary ? "binary" : "text") << " format";
+}
+
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Compact binary container for savegames.
+ * The brief save info stays as a YAML document at the start of the file,
+ * so save listings read it the same way as for text saves. The full save
+ * data follows as a binary encoding of the same YAML node tree, split in
+ * length-prefixed sections (one per top-level key) and read in one pass.
+ */
+namespace BinarySave
+{
+
+/// Current version of the binary format.
+const Uint32 VERSION = 1;
+
+/// Checks if file contents are in the binary format.
+bool isBinary(const std::string &data);
+/// Builds the contents of a binary save file.
+std::vector<unsigned char> write(const YAML::Node &brief, const YAML::Node &doc);
+/// Builds the contents of a text save file.
+std::string writeText(const YAML::Node &brief, const YAML::Node &doc);
+/// Reads the brief info and full save data from file contents in either format.
+std::vector<YAML::Node> read(const std::string &data);
+/// Converts a save file between the text and binary formats.
+void convert(const std::string &filepath, bool binary);
+
+}
+
+}
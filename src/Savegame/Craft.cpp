@@ -142,20 +142,8 @@ void Craft::load(const YAML::Node &node, const Mod *mod, SavedGame *save)
 		}
 	}
 
-	_items->load(node["items"]);
-	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
-	{
-		if (mod->getItem(i->first) == 0)
-		{
-			Log(LOG_ERROR) << "Failed to load item " << i->first;
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
-		}
-	}
+	// Some old saves have bad items, they are dropped to avoid further bugs
+	_items->load(node["items"], mod);
 	for (YAML::const_iterator i = node["vehicles"].begin(); i != node["vehicles"].end(); ++i)
 	{
 		std::string type = (*i)["type"].as<std::string>();
@@ -619,9 +607,9 @@ std::vector<Vehicle*> *Craft::getVehicles()
 /**
  * Gets the total storage size of all items in the craft. Including vehicles+ammo and craft weapons+ammo.
  */
-double Craft::getTotalItemStorageSize(const Mod* mod) const
+double Craft::getTotalItemStorageSize() const
 {
-	double total = _items->getTotalSize(mod);
+	double total = _items->getTotalSize();
 
 	for (const auto* v : _vehicles)
 	{
@@ -700,7 +688,7 @@ void Craft::addCraftStats(const RuleCraftStats& s)
 	int overflowFuel = _fuel - _stats.fuelMax;
 	if (overflowFuel > 0 && !_rules->getRefuelItem().empty())
 	{
-		_base->getStorageItems()->addItem(_rules->getRefuelItem(), overflowFuel / _rules->getRefuelRate());
+		_base->getStorageItems()->addItem(_base->getMod()->getItem(_rules->getRefuelItem()), overflowFuel / _rules->getRefuelRate());
 	}
 	setFuel(_fuel);
 
@@ -1330,11 +1318,11 @@ bool Craft::areOnlyPermittedSoldierTypesOnboard(const RuleStartingCondition* sc)
  * Checks if there are enough required items onboard.
  * @return True if the craft has enough required items.
  */
-bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems)
+bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems, const Mod *mod)
 {
 	for (auto& mapItem : requiredItems)
 	{
-		if (_items->getItem(mapItem.first) < mapItem.second)
+		if (_items->getItem(mod->getItem(mapItem.first)) < mapItem.second)
 		{
 			return false;
 		}
@@ -1345,11 +1333,11 @@ bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredIt
 /**
  * Destroys given required items.
  */
-void Craft::destroyRequiredItems(const std::map<std::string, int>& requiredItems)
+void Craft::destroyRequiredItems(const std::map<std::string, int>& requiredItems, const Mod *mod)
 {
 	for (auto& mapItem : requiredItems)
 	{
-		_items->removeItem(mapItem.first, mapItem.second);
+		_items->removeItem(mod->getItem(mapItem.first), mapItem.second);
 	}
 }
 
@@ -1632,15 +1620,15 @@ void Craft::unload()
 	}
 
 	// Remove items
-	for (std::map<std::string, int>::iterator it = _items->getContents()->begin(); it != _items->getContents()->end(); ++it)
+	for (const auto& it : *_items)
 	{
-		_base->getStorageItems()->addItem(it->first, it->second);
+		_base->getStorageItems()->addItem(it.first, it.second);
 	}
 
 	// Remove vehicles
 	for (std::vector<Vehicle*>::iterator v = _vehicles.begin(); v != _vehicles.end(); ++v)
 	{
-		_base->getStorageItems()->addItem((*v)->getRules()->getType());
+		_base->getStorageItems()->addItem((*v)->getRules());
 		if ((*v)->getRules()->getVehicleClipAmmo())
 		{
 			_base->getStorageItems()->addItem((*v)->getRules()->getVehicleClipAmmo(), (*v)->getRules()->getVehicleClipsLoaded());
@@ -131,7 +131,7 @@ public:
 	std::vector<Vehicle*> *getVehicles();
 
 	/// Gets the total storage size of all items in the craft. Including vehicles+ammo and craft weapons+ammo.
-	double getTotalItemStorageSize(const Mod* mod) const;
+	double getTotalItemStorageSize() const;
 	/// Gets the total number of items of a given type in the craft. Including vehicles+ammo and craft weapons+ammo.
 	int getTotalItemCount(const RuleItem* item) const;
 
@@ -218,9 +218,9 @@ public:
 	/// Checks if there are only permitted soldier types onboard.
 	bool areOnlyPermittedSoldierTypesOnboard(const RuleStartingCondition* sc);
 	/// Checks if there are enough required items onboard.
-	bool areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems);
+	bool areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems, const Mod *mod);
 	/// Destroys given required items.
-	void destroyRequiredItems(const std::map<std::string, int>& requiredItems);
+	void destroyRequiredItems(const std::map<std::string, int>& requiredItems, const Mod *mod);
 	/// Checks if there are enough pilots onboard.
 	bool arePilotsOnboard();
 	/// Checks if a pilot is already on the list.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "GameTime.h"
+#include <assert.h>
 #include "../Engine/Language.h"
 
 namespace OpenXcom
@@ -145,6 +146,30 @@ TimeTrigger GameTime::advance()
 	return trigger;
 }
 
+/**
+ * Gets how many calls to advance() are left until one of them
+ * returns something bigger than TIME_5SEC.
+ * @return Number of 5 second steps, including the triggering one.
+ */
+int GameTime::getStepsToNext10Minutes() const
+{
+	return (9 - _minute % 10) * 12 + (60 - _second) / 5;
+}
+
+/**
+ * Advances the time by several 5 second steps at once.
+ * The steps must stop short of the next 10 minute trigger,
+ * so only the minutes and seconds ever change.
+ * @param steps Number of 5 second steps.
+ */
+void GameTime::skipSteps(int steps)
+{
+	assert(steps < getStepsToNext10Minutes() && "Skipped over a time trigger.");
+	int seconds = _minute * 60 + _second + steps * 5;
+	_minute = seconds / 60;
+	_second = seconds % 60;
+}
+
 /**
  * Returns the current ingame second.
  * @return Second (0-59).
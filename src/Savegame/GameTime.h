@@ -52,6 +52,10 @@ public:
 	bool isLastDayOfMonth();
 	/// Advances the time by 5 seconds.
 	TimeTrigger advance();
+	/// Gets the number of 5 second steps until the next 10 minute trigger.
+	int getStepsToNext10Minutes() const;
+	/// Advances the time by several 5 second steps without triggers.
+	void skipSteps(int steps);
 	/// Gets the ingame second.
 	int getSecond() const;
 	/// Gets the ingame minute.
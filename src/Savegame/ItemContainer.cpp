@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ItemContainer.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
 
@@ -24,144 +26,158 @@ namespace OpenXcom
 {
 
 /**
- * Initializes an item container with no contents.
+ * Creates an iterator and moves it to the first item at or after the slot.
+ * @param container Container to iterate.
+ * @param index Starting slot.
  */
-ItemContainer::ItemContainer()
+ItemContainer::const_iterator::const_iterator(const ItemContainer *container, size_t index) : _container(container), _index(index), _current(nullptr, 0)
 {
+	skipEmpty();
 }
 
 /**
- *
+ * Moves to the first slot with a non-zero quantity at or after the current one.
  */
-ItemContainer::~ItemContainer()
+void ItemContainer::const_iterator::skipEmpty()
 {
+	const std::vector<int> &qty = _container->_qty;
+	while (_index < qty.size() && qty[_index] == 0)
+	{
+		++_index;
+	}
+	if (_index < qty.size())
+	{
+		_current = std::make_pair(_container->_rules[_index], qty[_index]);
+	}
 }
 
 /**
- * Loads the item container from a YAML file.
- * @param node YAML node.
+ * Moves to the next item in the container.
+ * @return This iterator.
  */
-void ItemContainer::load(const YAML::Node &node)
+ItemContainer::const_iterator &ItemContainer::const_iterator::operator++()
 {
-	_qty = node.as< std::map<std::string, int> >(_qty);
+	++_index;
+	skipEmpty();
+	return *this;
 }
 
 /**
- * Saves the item container to a YAML file.
- * @return YAML node.
+ * Initializes an item container with no contents.
  */
-YAML::Node ItemContainer::save() const
+ItemContainer::ItemContainer() : _revision(1), _totalSizeRevision(0), _totalSize(0)
 {
-	YAML::Node node;
-	node = _qty;
-	return node;
 }
 
 /**
- * Adds an item amount to the container.
- * @param id Item ID.
- * @param qty Item quantity.
+ *
  */
-void ItemContainer::addItem(const std::string &id, int qty)
+ItemContainer::~ItemContainer()
 {
-	if (id.empty())
+}
+
+/**
+ * Loads the item container from a YAML file.
+ * Unknown items are dropped, some old saves have bad items.
+ * @param node YAML node.
+ * @param mod Mod for the items.
+ */
+void ItemContainer::load(const YAML::Node &node, const Mod *mod)
+{
+	for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
 	{
-		return;
+		std::string type = i->first.as<std::string>();
+		const RuleItem *item = mod->getItem(type);
+		if (item == 0)
+		{
+			Log(LOG_ERROR) << "Failed to load item " << type;
+			continue;
+		}
+		addItem(item, i->second.as<int>());
 	}
-	_qty[id] += qty;
 }
 
 /**
- * Adds an item amount to the container.
- * @param id Item ID.
- * @param qty Item quantity.
+ * Saves the item container to a YAML file.
+ * @return YAML node.
  */
-void ItemContainer::addItem(const RuleItem* item, int qty)
+YAML::Node ItemContainer::save() const
 {
-	if (item)
+	YAML::Node node(YAML::NodeType::Map);
+	for (const auto& i : *this)
 	{
-		addItem(item->getType(), qty);
+		node[i.first->getType()] = i.second;
 	}
+	return node;
 }
 
 /**
- * Removes an item amount from the container.
- * @param id Item ID.
+ * Adds an item amount to the container.
+ * @param item Item type.
  * @param qty Item quantity.
  */
-void ItemContainer::removeItem(const std::string &id, int qty)
+void ItemContainer::addItem(const RuleItem* item, int qty)
 {
-	if (id.empty())
+	if (!item)
 	{
 		return;
 	}
-	auto it = _qty.find(id);
-	if (it == _qty.end())
+	size_t index = item->getIndex();
+	if (index >= _qty.size())
 	{
-		return;
-	}
-
-	if (qty < it->second)
-	{
-		it->second -= qty;
-	}
-	else
-	{
-		_qty.erase(it);
+		_qty.resize(index + 1, 0);
+		_rules.resize(index + 1, nullptr);
 	}
+	_qty[index] += qty;
+	_rules[index] = item;
+	++_revision;
 }
 
 /**
  * Removes an item amount from the container.
- * @param id Item ID.
+ * @param item Item type.
  * @param qty Item quantity.
  */
 void ItemContainer::removeItem(const RuleItem* item, int qty)
 {
-	if (item)
+	if (!item)
 	{
-		removeItem(item->getType(), qty);
+		return;
 	}
-}
-
-/**
- * Returns the quantity of an item in the container.
- * @param id Item ID.
- * @return Item quantity.
- */
-int ItemContainer::getItem(const std::string &id) const
-{
-	if (id.empty())
+	size_t index = item->getIndex();
+	if (index >= _qty.size() || _qty[index] == 0)
 	{
-		return 0;
+		return;
 	}
 
-	auto it = _qty.find(id);
-	if (it == _qty.end())
+	if (qty < _qty[index])
 	{
-		return 0;
+		_qty[index] -= qty;
 	}
 	else
 	{
-		return it->second;
+		_qty[index] = 0;
 	}
+	++_revision;
 }
 
 /**
  * Returns the quantity of an item in the container.
- * @param id Item ID.
+ * @param item Item type.
  * @return Item quantity.
  */
 int ItemContainer::getItem(const RuleItem* item) const
 {
-	if (item)
+	if (!item)
 	{
-		return getItem(item->getType());
+		return 0;
 	}
-	else
+	size_t index = item->getIndex();
+	if (index >= _qty.size())
 	{
 		return 0;
 	}
+	return _qty[index];
 }
 
 /**
@@ -171,35 +187,74 @@ int ItemContainer::getItem(const RuleItem* item) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (int qty : _qty)
 	{
-		total += i->second;
+		total += qty;
 	}
 	return total;
 }
 
 /**
- * Returns the total size of the items in the container.
- * @param mod Pointer to mod.
+ * Sums up the size of all the items in the container.
  * @return Total item size.
  */
-double ItemContainer::getTotalSize(const Mod *mod) const
+double ItemContainer::calculateTotalSize() const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (size_t i = 0; i < _qty.size(); ++i)
 	{
-		total += mod->getItem(i->first, true)->getSize() * i->second;
+		if (_qty[i] != 0)
+		{
+			total += _rules[i]->getSize() * _qty[i];
+		}
 	}
 	return total;
 }
 
 /**
- * Returns all the items currently contained within.
- * @return List of contents.
+ * Returns the total size of the items in the container.
+ * The sum is kept until the contents change, stores are
+ * checked far more often than they are modified.
+ * With the verification option on it is also checked
+ * against a fresh sum on every call.
+ * @return Total item size.
+ */
+double ItemContainer::getTotalSize() const
+{
+	if (_totalSizeRevision != _revision)
+	{
+		_totalSize = calculateTotalSize();
+		_totalSizeRevision = _revision;
+	}
+	else if (Options::oxceVerifyBaseCapacities)
+	{
+		double fresh = calculateTotalSize();
+		if (fresh != _totalSize)
+		{
+			Log(LOG_ERROR) << "Cached total size of item container is out of date.";
+			_totalSize = fresh;
+		}
+	}
+	return _totalSize;
+}
+
+/**
+ * Checks if the container has no items.
+ * @return True if empty.
+ */
+bool ItemContainer::empty() const
+{
+	return begin() == end();
+}
+
+/**
+ * Removes all items from the container.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+void ItemContainer::clear()
 {
-	return &_qty;
+	_qty.clear();
+	_rules.clear();
+	++_revision;
 }
 
 }
@@ -17,8 +17,8 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <string>
-#include <map>
+#include <vector>
+#include <utility>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -31,38 +31,67 @@ class RuleItem;
  * Represents the items contained by a certain entity,
  * like base stores, craft equipment, etc.
  * Handles all necessary item management tasks.
+ * Quantities are stored in a flat array indexed by the dense item index,
+ * so lookups never compare strings.
  */
 class ItemContainer
 {
 private:
-	std::map<std::string, int> _qty;
+	std::vector<int> _qty;
+	std::vector<const RuleItem*> _rules;
+	unsigned _revision;
+	mutable unsigned _totalSizeRevision;
+	mutable double _totalSize;
+
+	/// Sums up the size of all the items.
+	double calculateTotalSize() const;
 public:
+	/// Iterates over the items with a non-zero quantity, in item name order.
+	class const_iterator
+	{
+		const ItemContainer *_container;
+		size_t _index;
+		std::pair<const RuleItem*, int> _current;
+
+		/// Moves to the first non-empty slot at or after the current one.
+		void skipEmpty();
+	public:
+		const_iterator(const ItemContainer *container, size_t index);
+		const std::pair<const RuleItem*, int> &operator*() const { return _current; }
+		const std::pair<const RuleItem*, int> *operator->() const { return &_current; }
+		const_iterator &operator++();
+		bool operator==(const const_iterator &other) const { return _index == other._index; }
+		bool operator!=(const const_iterator &other) const { return _index != other._index; }
+	};
+
 	/// Creates an empty item container.
 	ItemContainer();
 	/// Cleans up the item container.
 	~ItemContainer();
 	/// Loads the item container from YAML.
-	void load(const YAML::Node& node);
+	void load(const YAML::Node& node, const Mod *mod);
 	/// Saves the item container to YAML.
 	YAML::Node save() const;
 	/// Adds an item to the container.
-	void addItem(const std::string &id, int qty = 1);
-	/// Adds an item to the container.
 	void addItem(const RuleItem* item, int qty = 1);
 	/// Removes an item from the container.
-	void removeItem(const std::string &id, int qty = 1);
-	/// Removes an item from the container.
 	void removeItem(const RuleItem* item, int qty = 1);
 	/// Gets an item in the container.
-	int getItem(const std::string &id) const;
-	/// Gets an item in the container.
 	int getItem(const RuleItem* item) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
-	double getTotalSize(const Mod *mod) const;
-	/// Gets all the items in the container.
-	std::map<std::string, int> *getContents();
+	double getTotalSize() const;
+	/// Gets a number that changes every time the contents change.
+	unsigned getRevision() const { return _revision; }
+	/// Checks if the container has no items.
+	bool empty() const;
+	/// Removes all items from the container.
+	void clear();
+	/// Gets the first item in the container.
+	const_iterator begin() const { return const_iterator(this, 0); }
+	/// Gets the end of the items in the container.
+	const_iterator end() const { return const_iterator(this, _qty.size()); }
 };
 
 }
@@ -234,6 +234,30 @@ void MovingTarget::move()
 	}
 }
 
+/**
+ * Moves several steps towards the destination in one go,
+ * along the great circle instead of re-aiming after every step.
+ * Only meant for fixed destinations further away than the steps cover,
+ * arriving is left to move().
+ * @param steps Number of steps to move.
+ */
+void MovingTarget::moveSteps(int steps)
+{
+	if (_dest == 0 || steps <= 0)
+	{
+		return;
+	}
+	double lat2 = _dest->getLatitude();
+	double dLon = _dest->getLongitude() - _lon;
+	double heading = atan2(sin(dLon) * cos(lat2), cos(_lat) * sin(lat2) - sin(_lat) * cos(lat2) * cos(dLon));
+	double d = steps * _speedRadian;
+	double lat = asin(sin(_lat) * cos(d) + cos(_lat) * sin(d) * cos(heading));
+	double lon = _lon + atan2(sin(heading) * sin(d) * cos(_lat), cos(d) - sin(_lat) * sin(lat));
+	setLongitude(lon);
+	setLatitude(lat);
+	resetMeetPoint();
+}
+
 /**
  * Calculate meeting point with the target.
  */
@@ -64,6 +64,8 @@ public:
 	bool reachedDestination() const;
 	/// Move towards the destination.
 	void move();
+	/// Move several steps towards a fixed destination at once.
+	void moveSteps(int steps);
 	/// Calculate meeting point with the target.
 	void calculateMeetPoint();
 	/// Returns the latitude of the meeting point.
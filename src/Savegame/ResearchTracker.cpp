@@ -0,0 +1,243 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ResearchTracker.h"
+#include "../Mod/Mod.h"
+#include "../Mod/RuleResearch.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+bool getBit(const std::vector<Uint64> &bits, int index)
+{
+	return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+void setBit(std::vector<Uint64> &bits, int index, bool value)
+{
+	if (value)
+	{
+		bits[index / 64] |= (Uint64)1 << (index % 64);
+	}
+	else
+	{
+		bits[index / 64] &= ~((Uint64)1 << (index % 64));
+	}
+}
+
+}
+
+/**
+ * Creates an empty tracker, it needs to be built before use.
+ */
+ResearchTracker::ResearchTracker() : _mod(0)
+{
+}
+
+/**
+ * Checks if the tracker was built for the given mod.
+ * @param mod Game mod.
+ * @return True if the state can be used.
+ */
+bool ResearchTracker::isBuilt(const Mod *mod) const
+{
+	return _mod != 0 && _mod == mod;
+}
+
+/**
+ * Builds the whole state from the discovered topics and the rule statuses.
+ * @param mod Game mod, research rules must have their indexes assigned.
+ * @param discovered Discovered topics.
+ * @param status Research rule statuses by name.
+ */
+void ResearchTracker::build(const Mod *mod, const std::vector<const RuleResearch*> &discovered, const std::map<std::string, int> &status)
+{
+	const std::map<std::string, RuleResearch*> &research = mod->getResearchMap();
+	size_t size = research.size();
+	size_t words = (size + 63) / 64;
+
+	_mod = mod;
+	_topics.assign(size, 0);
+	_dependents.assign(size, std::vector<int>());
+	_requiredBy.assign(size, std::vector<int>());
+	_discovered.assign(words, 0);
+	_disabled.assign(words, 0);
+	_available.assign(words, 0);
+	_unlockCount.assign(size, 0);
+	_missingDependencies.assign(size, 0);
+	_missingRequirements.assign(size, 0);
+
+	for (auto& pair : research)
+	{
+		RuleResearch *r = pair.second;
+		int index = r->getIndex();
+		_topics[index] = r;
+		for (auto dep : r->getDependencies())
+		{
+			_dependents[dep->getIndex()].push_back(index);
+		}
+		for (auto req : r->getRequirements())
+		{
+			_requiredBy[req->getIndex()].push_back(index);
+		}
+		_missingDependencies[index] = r->getDependencies().size();
+		_missingRequirements[index] = r->getRequirements().size();
+	}
+	for (auto& pair : status)
+	{
+		if (pair.second == RuleResearch::RESEARCH_STATUS_DISABLED)
+		{
+			auto r = research.find(pair.first);
+			if (r != research.end())
+			{
+				setBit(_disabled, r->second->getIndex(), true);
+			}
+		}
+	}
+	for (size_t i = 0; i < size; ++i)
+	{
+		update(i);
+	}
+	for (auto r : discovered)
+	{
+		setDiscovered(r, true);
+	}
+}
+
+/**
+ * Forgets the state, so it is built again on next use.
+ */
+void ResearchTracker::clear()
+{
+	_mod = 0;
+}
+
+/**
+ * Recalculates the availability bit of a topic from its counters.
+ * @param index Research index.
+ */
+void ResearchTracker::update(int index)
+{
+	bool available = !getBit(_disabled, index)
+		&& _missingRequirements[index] == 0
+		&& (_unlockCount[index] > 0 || _missingDependencies[index] == 0);
+	setBit(_available, index, available);
+}
+
+/**
+ * Marks a topic as discovered or not and updates all topics depending on it.
+ * @param research Research topic.
+ * @param discovered New state.
+ */
+void ResearchTracker::setDiscovered(const RuleResearch *research, bool discovered)
+{
+	if (_mod == 0)
+	{
+		return;
+	}
+	int index = research->getIndex();
+	if (index < 0 || (size_t)index >= _topics.size() || _topics[index] != research)
+	{
+		// rule from another mod, start over on next use
+		clear();
+		return;
+	}
+	if (getBit(_discovered, index) == discovered)
+	{
+		return;
+	}
+	setBit(_discovered, index, discovered);
+
+	int change = discovered ? 1 : -1;
+	for (auto unlock : research->getUnlocked())
+	{
+		_unlockCount[unlock->getIndex()] += change;
+		update(unlock->getIndex());
+	}
+	for (int dep : _dependents[index])
+	{
+		_missingDependencies[dep] -= change;
+		update(dep);
+	}
+	for (int req : _requiredBy[index])
+	{
+		_missingRequirements[req] -= change;
+		update(req);
+	}
+}
+
+/**
+ * Marks a topic as permanently disabled or not.
+ * @param name Research rule ID.
+ * @param disabled New state.
+ */
+void ResearchTracker::setDisabled(const std::string &name, bool disabled)
+{
+	if (_mod == 0)
+	{
+		return;
+	}
+	const RuleResearch *research = _mod->getResearch(name, false);
+	if (research == 0)
+	{
+		// status of a topic missing in the mod, nothing to track
+		return;
+	}
+	setBit(_disabled, research->getIndex(), disabled);
+	update(research->getIndex());
+}
+
+/**
+ * Gets the topics that are not disabled, have all their requirements discovered
+ * and either all their dependencies discovered or are unlocked by a discovered topic.
+ * @param topics List to fill, in research name order.
+ */
+void ResearchTracker::getAvailable(std::vector<RuleResearch*> &topics) const
+{
+	for (size_t w = 0; w < _available.size(); ++w)
+	{
+		Uint64 bits = _available[w];
+		for (int i = 0; bits != 0; ++i, bits >>= 1)
+		{
+			if (bits & 1)
+			{
+				topics.push_back(_topics[w * 64 + i]);
+			}
+		}
+	}
+}
+
+/**
+ * Gets all topics that are not permanently disabled.
+ * @param topics List to fill, in research name order.
+ */
+void ResearchTracker::getNotDisabled(std::vector<RuleResearch*> &topics) const
+{
+	for (size_t i = 0; i < _topics.size(); ++i)
+	{
+		if (!getBit(_disabled, i))
+		{
+			topics.push_back(_topics[i]);
+		}
+	}
+}
+
+}
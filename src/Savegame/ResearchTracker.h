@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class Mod;
+class RuleResearch;
+
+/**
+ * Research state of a saved game indexed by the dense research ids.
+ * Keeps discovered and disabled topics as bitsets, together with counters
+ * of unlocking topics, missing dependencies and missing requirements,
+ * so the set of topics that pass the static availability checks is
+ * updated on each change instead of being rebuilt on every query.
+ */
+class ResearchTracker
+{
+private:
+	const Mod *_mod;
+	std::vector<RuleResearch*> _topics;
+	std::vector<std::vector<int> > _dependents, _requiredBy;
+	std::vector<Uint64> _discovered, _disabled, _available;
+	std::vector<int> _unlockCount, _missingDependencies, _missingRequirements;
+
+	/// Recalculates the availability bit of a topic.
+	void update(int index);
+public:
+	/// Creates an empty tracker.
+	ResearchTracker();
+	/// Checks if the tracker was built for the given mod.
+	bool isBuilt(const Mod *mod) const;
+	/// Builds the state from scratch.
+	void build(const Mod *mod, const std::vector<const RuleResearch*> &discovered, const std::map<std::string, int> &status);
+	/// Forgets the state, it will be rebuilt on next use.
+	void clear();
+	/// Marks a topic as discovered or not.
+	void setDiscovered(const RuleResearch *research, bool discovered);
+	/// Marks a topic as permanently disabled or not.
+	void setDisabled(const std::string &name, bool disabled);
+	/// Gets the topics that are not disabled and have their dependencies (or an unlock) and requirements discovered.
+	void getAvailable(std::vector<RuleResearch*> &topics) const;
+	/// Gets all topics that are not disabled.
+	void getNotDisabled(std::vector<RuleResearch*> &topics) const;
+};
+
+}
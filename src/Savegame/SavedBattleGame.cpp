@@ -59,7 +59,7 @@ namespace OpenXcom
  */
 SavedBattleGame::SavedBattleGame(Mod *rule, Language *lang) :
 	_battleState(0), _rule(rule), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0), _selectedUnit(0),
-	_lastSelectedUnit(0), _pathfinding(0), _tileEngine(0),
+	_lastSelectedUnit(0), _pathfinding(0), _tileEngine(0), _exposureMap(0),
 	_reinforcementsItemLevel(0), _enviroEffects(nullptr), _ecEnabledFriendly(false), _ecEnabledHostile(false), _ecEnabledNeutral(false),
 	_globalShade(0), _side(FACTION_PLAYER), _turn(0), _bughuntMinTurn(20), _animFrame(0), _nameDisplay(false),
 	_debugMode(false), _bughuntMode(false), _aborted(false), _itemId(0),
@@ -120,6 +120,7 @@ SavedBattleGame::~SavedBattleGame()
 
 	delete _pathfinding;
 	delete _tileEngine;
+	delete _exposureMap;
 	delete _baseItems;
 	delete _hitLog;
 }
@@ -404,7 +405,7 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 	_maxAmbienceRandomDelay = node["maxAmbienceRandomDelay"].as<int>(_maxAmbienceRandomDelay);
 	_currentAmbienceDelay = node["currentAmbienceDelay"].as<int>(_currentAmbienceDelay);
 	_music = node["music"].as<std::string>(_music);
-	_baseItems->load(node["baseItems"]);
+	_baseItems->load(node["baseItems"], mod);
 	_turnLimit = node["turnLimit"].as<int>(_turnLimit);
 	_chronoTrigger = ChronoTrigger(node["chronoTrigger"].as<int>(_chronoTrigger));
 	_cheatTurn = node["cheatTurn"].as<int>(_cheatTurn);
@@ -629,9 +630,11 @@ void SavedBattleGame::initUtilities(Mod *mod, bool craftInventory)
 {
 	delete _pathfinding;
 	delete _tileEngine;
+	delete _exposureMap;
 	_baseCraftInventory = craftInventory;
 	_pathfinding = craftInventory ? nullptr : new Pathfinding(this);
 	_tileEngine = new TileEngine(this, mod);
+	_exposureMap = new AIExposureMap(this);
 }
 
 /**
@@ -992,6 +995,15 @@ TileEngine *SavedBattleGame::getTileEngine() const
 	return _tileEngine;
 }
 
+/**
+ * Gets the map of tiles exposed to enemies, shared by the AI.
+ * @return Pointer to the exposure map.
+ */
+AIExposureMap *SavedBattleGame::getExposureMap() const
+{
+	return _exposureMap;
+}
+
 /**
  * Gets the array of mapblocks.
  * @return Pointer to the array of mapblocks.
@@ -1172,6 +1184,12 @@ void SavedBattleGame::newTurnUpdateScripts()
  */
 void SavedBattleGame::endTurn()
 {
+	// the sides moved and the terrain may have changed since the exposure was traced
+	if (_exposureMap)
+	{
+		_exposureMap->invalidate();
+	}
+
 	// reset turret direction for all hostile and neutral units (as it may have been changed during reaction fire)
 	for (std::vector<BattleUnit*>::iterator i = _units.begin(); i != _units.end(); ++i)
 	{
@@ -1934,6 +1952,8 @@ void SavedBattleGame::prepareNewTurn()
 						}
 					}
 				}
+				getPathfinding()->invalidateTerrainCache((*i)->getPosition());
+				getExposureMap()->invalidate();
 				getTileEngine()->applyGravity(*i);
 			}
 		}
@@ -35,6 +35,7 @@ class BattlescapeGame;
 class Position;
 class Pathfinding;
 class TileEngine;
+class AIExposureMap;
 class RuleEnviroEffects;
 class BattleItem;
 class BattleUnit;
@@ -70,6 +71,7 @@ private:
 	std::vector<BattleItem*> _items, _deleted;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
+	AIExposureMap *_exposureMap;
 	std::string _missionType, _strTarget, _strCraftOrBase, _alienCustomDeploy, _alienCustomMission;
 	std::string _reinforcementsDeployment, _reinforcementsRace;
 	int _reinforcementsItemLevel;
@@ -334,6 +336,8 @@ public:
 	Pathfinding *getPathfinding() const;
 	/// Gets a pointer to the tile engine.
 	TileEngine *getTileEngine() const;
+	/// Gets the AI exposure map.
+	AIExposureMap *getExposureMap() const;
 	/// Gets the playing side.
 	UnitFaction getSide() const;
 	/// Can unit use that weapon?
@@ -34,6 +34,8 @@
 #include "../Engine/ScriptBind.h"
 #include "SavedBattleGame.h"
 #include "SerializationHelper.h"
+#include "BinarySave.h"
+#include "ResearchTracker.h"
 #include "GameTime.h"
 #include "Country.h"
 #include "Base.h"
@@ -76,6 +78,89 @@ const std::string SavedGame::AUTOSAVE_GEOSCAPE = "_autogeo_.asav",
 namespace
 {
 
+/// File in the user folder caching the brief info of all saves.
+const std::string SAVE_INDEX = "saveindex.yml";
+
+/**
+ * Brief info of a save, together with the file state it was read from.
+ * Saves that failed to load are kept too, so they are not reparsed on every listing.
+ */
+struct SaveIndexEntry
+{
+	time_t timestamp;
+	Uint64 size;
+	bool broken;
+	YAML::Node brief;
+};
+
+/**
+ * Loads the save index of a user folder.
+ * A missing or broken index is just treated as empty.
+ * @param folder Full path to the user folder.
+ * @return Index entries by save filename.
+ */
+std::map<std::string, SaveIndexEntry> loadSaveIndex(const std::string &folder)
+{
+	std::map<std::string, SaveIndexEntry> index;
+	std::string filename = folder + SAVE_INDEX;
+	if (!CrossPlatform::fileExists(filename))
+	{
+		return index;
+	}
+	try
+	{
+		YAML::Node doc = YAML::Load(*CrossPlatform::readFile(filename));
+		for (YAML::const_iterator i = doc.begin(); i != doc.end(); ++i)
+		{
+			SaveIndexEntry entry;
+			entry.timestamp = (time_t)i->second["timestamp"].as<Sint64>();
+			entry.size = i->second["size"].as<Uint64>();
+			entry.broken = i->second["broken"].as<bool>(false);
+			entry.brief = i->second["brief"];
+			index[i->first.as<std::string>()] = entry;
+		}
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_WARNING) << filename << ": " << e.what();
+		index.clear();
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_WARNING) << filename << ": " << e.what();
+		index.clear();
+	}
+	return index;
+}
+
+/**
+ * Saves the save index of a user folder.
+ * @param folder Full path to the user folder.
+ * @param index Index entries by save filename.
+ */
+void saveSaveIndex(const std::string &folder, const std::map<std::string, SaveIndexEntry> &index)
+{
+	YAML::Node doc;
+	for (std::map<std::string, SaveIndexEntry>::const_iterator i = index.begin(); i != index.end(); ++i)
+	{
+		YAML::Node node;
+		node["timestamp"] = (Sint64)i->second.timestamp;
+		node["size"] = i->second.size;
+		if (i->second.broken)
+		{
+			node["broken"] = true;
+		}
+		else
+		{
+			node["brief"] = i->second.brief;
+		}
+		doc[i->first] = node;
+	}
+	YAML::Emitter out;
+	out << doc;
+	CrossPlatform::writeFile(folder + SAVE_INDEX, out.c_str());
+}
+
 struct findRuleResearch
 {
 	typedef ResearchProject* argument_type;
@@ -148,6 +233,7 @@ SavedGame::SavedGame() : _difficulty(DIFF_BEGINNER), _end(END_NONE), _ironman(fa
 {
 	_time = new GameTime(6, 1, 1, 1999, 12, 0, 0);
 	_alienStrategy = new AlienStrategy();
+	_researchTracker = new ResearchTracker();
 	_funds.push_back(0);
 	_maintenance.push_back(0);
 	_researchScores.push_back(0);
@@ -196,6 +282,7 @@ SavedGame::~SavedGame()
 		delete *i;
 	}
 	delete _alienStrategy;
+	delete _researchTracker;
 	for (std::vector<AlienMission*>::iterator i = _activeMissions.begin(); i != _activeMissions.end(); ++i)
 	{
 		delete *i;
@@ -285,35 +372,85 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 {
 	std::vector<SaveInfo> info;
 	std::string curMaster = Options::getActiveMaster();
-	auto saves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "sav");
+	std::string folder = Options::getMasterUserFolder();
+	auto saves = CrossPlatform::getFolderContents(folder, "sav");
 
 	if (autoquick)
 	{
-		auto asaves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "asav");
+		auto asaves = CrossPlatform::getFolderContents(folder, "asav");
 		saves.insert(saves.begin(), asaves.begin(), asaves.end());
 	}
+
+	// only saves changed since the last listing need their header parsed
+	std::map<std::string, SaveIndexEntry> oldIndex = loadSaveIndex(folder);
+	std::map<std::string, SaveIndexEntry> index;
+	bool indexChanged = false;
+	if (!autoquick)
+	{
+		for (std::map<std::string, SaveIndexEntry>::const_iterator i = oldIndex.begin(); i != oldIndex.end(); ++i)
+		{
+			if (CrossPlatform::getExt(i->first) == ".asav")
+			{
+				index.insert(*i);
+			}
+		}
+	}
 	for (auto i = saves.begin(); i != saves.end(); ++i)
 	{
 		auto filename = std::get<0>(*i);
+		std::string fullname = folder + filename;
+		SaveIndexEntry entry;
+		entry.timestamp = std::get<2>(*i);
+		entry.size = CrossPlatform::getFileSize(fullname);
+		entry.broken = false;
+		std::map<std::string, SaveIndexEntry>::const_iterator cached = oldIndex.find(filename);
+		bool upToDate = cached != oldIndex.end() && cached->second.timestamp == entry.timestamp && cached->second.size == entry.size;
+		if (upToDate && cached->second.broken)
+		{
+			// already reported when it was first found
+			index[filename] = cached->second;
+			continue;
+		}
+		std::string error;
 		try
 		{
-			SaveInfo saveInfo = getSaveInfo(filename, lang);
+			if (upToDate)
+			{
+				entry.brief = cached->second.brief;
+			}
+			else
+			{
+				entry.brief = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+				indexChanged = true;
+			}
+
+			SaveInfo saveInfo = getSaveInfo(filename, entry.brief, entry.timestamp, lang);
+			index[filename] = entry;
 			if (!_isCurrentGameType(saveInfo, curMaster))
 			{
 				continue;
 			}
 			info.push_back(saveInfo);
+			continue;
 		}
 		catch (Exception &e)
 		{
-			Log(LOG_ERROR) << filename << ": " << e.what();
-			continue;
+			error = e.what();
 		}
 		catch (YAML::Exception &e)
 		{
-			Log(LOG_ERROR) << filename << ": " << e.what();
-			continue;
+			error = e.what();
 		}
+		Log(LOG_ERROR) << filename << ": " << error;
+		entry.broken = true;
+		entry.brief = YAML::Node();
+		index[filename] = entry;
+		indexChanged = true;
+	}
+
+	if (indexChanged || index.size() != oldIndex.size())
+	{
+		saveSaveIndex(folder, index);
 	}
 
 	return info;
@@ -322,12 +459,12 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 /**
  * Gets the info of a specific save file.
  * @param file Save filename.
+ * @param doc Brief info from the save header.
+ * @param timestamp Last modified date of the save.
  * @param lang Loaded language.
  */
-SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
+SaveInfo SavedGame::getSaveInfo(const std::string &file, const YAML::Node &doc, time_t timestamp, Language *lang)
 {
-	std::string fullname = Options::getMasterUserFolder() + file;
-	YAML::Node doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
 	SaveInfo save;
 
 	save.fileName = file;
@@ -360,7 +497,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 		save.reserved = false;
 	}
 
-	save.timestamp = CrossPlatform::getDateModified(fullname);
+	save.timestamp = timestamp;
 	std::pair<std::string, std::string> str = CrossPlatform::timeToString(save.timestamp);
 	save.isoDate = str.first;
 	save.isoTime = str.second;
@@ -399,7 +536,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 {
 	std::string filepath = Options::getMasterUserFolder() + filename;
-	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filepath));
+	std::vector<YAML::Node> file = BinarySave::read(CrossPlatform::readFileRaw(filepath));
 	// Get brief save info
 	YAML::Node brief = file[0];
 	_time->load(brief["time"]);
@@ -743,7 +880,7 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
 		std::string key = oss.str();
 		if (const YAML::Node &loadout = doc[key])
 		{
-			_globalCraftLoadout[j]->load(loadout);
+			_globalCraftLoadout[j]->load(loadout, mod);
 		}
 		std::ostringstream oss2;
 		oss2 << "globalCraftLoadoutName" << j;
@@ -785,8 +922,6 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang)
  */
 void SavedGame::save(const std::string &filename, Mod *mod) const
 {
-	YAML::Emitter out;
-
 	// Saves the brief game info used in the saves list
 	YAML::Node brief;
 	brief["name"] = _name;
@@ -816,9 +951,7 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	brief["mods"] = modsList;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
 	// Saves the full game data to the save
-	out << YAML::BeginDoc;
 	YAML::Node node;
 	node["difficulty"] = (int)_difficulty;
 	node["end"] = (int)_end;
@@ -925,7 +1058,7 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 		std::ostringstream oss;
 		oss << "globalCraftLoadout" << j;
 		std::string key = oss.str();
-		if (!_globalCraftLoadout[j]->getContents()->empty())
+		if (!_globalCraftLoadout[j]->empty())
 		{
 			node[key] = _globalCraftLoadout[j]->save();
 		}
@@ -954,11 +1087,17 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	}
 	_scriptValues.save(node, mod->getScriptGlobal());
 
-	out << node;
-
-
 	std::string filepath = Options::getMasterUserFolder() + filename;
-	if (!CrossPlatform::writeFile(filepath, out.c_str()))
+	bool written;
+	if (Options::oxceBinarySaves)
+	{
+		written = CrossPlatform::writeFile(filepath, BinarySave::write(brief, node));
+	}
+	else
+	{
+		written = CrossPlatform::writeFile(filepath, BinarySave::writeText(brief, node));
+	}
+	if (!written)
 	{
 		throw Exception("Failed to save " + filepath);
 	}
@@ -1393,7 +1532,13 @@ void SavedGame::setManufactureRuleStatus(const std::string &manufactureRule, int
 */
 void SavedGame::setResearchRuleStatus(const std::string &researchRule, int newStatus)
 {
+	bool wasDisabled = isResearchRuleStatusDisabled(researchRule);
 	_researchRuleStatus[researchRule] = newStatus;
+	bool disabled = newStatus == RuleResearch::RESEARCH_STATUS_DISABLED;
+	if (wasDisabled != disabled)
+	{
+		_researchTracker->setDisabled(researchRule, disabled);
+	}
 }
 
 /**
@@ -1477,6 +1622,10 @@ void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
 	if (r != _discovered.end())
 	{
 		_discovered.erase(r);
+		if (!haveReserchVector(_discovered, research))
+		{
+			_researchTracker->setDiscovered(research, false);
+		}
 	}
 }
 
@@ -1486,8 +1635,8 @@ void SavedGame::removeDiscoveredResearch(const RuleResearch * research)
  */
 void SavedGame::addFinishedResearchSimple(const RuleResearch * research)
 {
-	_discovered.push_back(research);
-	sortReserchVector(_discovered);
+	_discovered.insert(std::upper_bound(_discovered.begin(), _discovered.end(), research, researchLess), research);
+	_researchTracker->setDiscovered(research, true);
 }
 
 /**
@@ -1522,8 +1671,7 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 		bool checkRelatedZeroCostTopics = true;
 		if (!isResearched(currentQueueItem, false))
 		{
-			_discovered.push_back(currentQueueItem);
-			sortReserchVector(_discovered);
+			addFinishedResearchSimple(currentQueueItem);
 			if (!hasUndiscoveredProtectedUnlocks && !hasAnyUndiscoveredGetOneFrees)
 			{
 				// If the currentQueueItem can't tell you anything anymore, remove it from popped research
@@ -1636,55 +1784,36 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
  */
 void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projects, const Mod *mod, Base *base, bool considerDebugMode) const
 {
-	// This list is used for topics that can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
-	// Note: all requirements of such topics *have to* be discovered though! This will be handled elsewhere.
-	std::vector<const RuleResearch *> unlocked;
-	for (const RuleResearch *research : _discovered)
+	if (!_researchTracker->isBuilt(mod))
 	{
-		for (auto& itUnlocked : research->getUnlocked())
-		{
-			unlocked.push_back(itUnlocked);
-		}
-		sortReserchVector(unlocked);
+		_researchTracker->build(mod, _discovered, _researchRuleStatus);
 	}
 
-	// Create a list of research topics available for research in the given base
-	for (auto& pair : mod->getResearchMap())
+	// The research state already filters out:
+	// - permanently disabled topics
+	// - topics with undiscovered "dependencies", unless a discovered topic unlocks them (e.g. STR_ALIEN_ORIGINS)
+	// - topics with undiscovered "requires"
+	// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
+	//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
+	//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
+	//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
+	//     - Note: when called from there, parameter considerDebugMode = false
+	std::vector<RuleResearch *> candidates;
+	if (considerDebugMode && _debug)
 	{
-		// This research topic is permanently disabled, ignore it!
-		if (isResearchRuleStatusDisabled(pair.first))
-		{
-			continue;
-		}
-
-		RuleResearch *research = pair.second;
-
-		if ((considerDebugMode && _debug) || haveReserchVector(unlocked, research))
-		{
-			// Empty, these research topics are on the "unlocked list", *don't* check the dependencies!
-		}
-		else
-		{
-			// These items are not on the "unlocked list", we must check if "dependencies" are satisfied!
-			if (!isResearched(research->getDependencies(), considerDebugMode))
-			{
-				continue;
-			}
-		}
-
-		// Check if "requires" are satisfied
-		// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
-		//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
-		//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
-		//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
-		//     - Note: when called from there, parameter considerDebugMode = false
-		if (!isResearched(research->getRequirements(), considerDebugMode))
-		{
-			continue;
-		}
+		// debug mode ignores "dependencies" and "requires"
+		_researchTracker->getNotDisabled(candidates);
+	}
+	else
+	{
+		_researchTracker->getAvailable(candidates);
+	}
 
+	// Create a list of research topics available for research in the given base
+	for (RuleResearch *research : candidates)
+	{
 		// Remove the already researched topics from the list *UNLESS* they can still give you something more
-		if (isResearched(research->getName(), false))
+		if (isResearched(research, false))
 		{
 			if (hasUndiscoveredGetOneFree(research, true))
 			{
@@ -1711,7 +1840,7 @@ void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> &projec
 			}
 
 			// Check for needed item in the given base
-			if (research->needItem() && base->getStorageItems()->getItem(research->getName()) == 0)
+			if (research->needItem() && base->getStorageItems()->getItem(mod->getItem(research->getName())) == 0)
 			{
 				continue;
 			}
@@ -2138,13 +2267,15 @@ bool SavedGame::isResearched(const std::vector<const RuleResearch *> &research,
  * Returns if a certain item has been obtained, i.e. is present directly in the base stores.
  * Items in and on craft, in transfer, worn by soldiers, etc. are ignored!!
  * @param itemType Item ID.
+ * @param mod the game Mod
  * @return Whether it's obtained or not.
  */
-bool SavedGame::isItemObtained(const std::string &itemType) const
+bool SavedGame::isItemObtained(const std::string &itemType, const Mod *mod) const
 {
+	const RuleItem *item = mod->getItem(itemType);
 	for (auto base : _bases)
 	{
-		if (base->getStorageItems()->getItem(itemType) > 0)
+		if (base->getStorageItems()->getItem(item) > 0)
 			return true;
 	}
 	return false;
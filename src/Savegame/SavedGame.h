@@ -53,6 +53,7 @@ class ArticleDefinition;
 class MissionSite;
 class AlienBase;
 class AlienStrategy;
+class ResearchTracker;
 class AlienMission;
 class GeoscapeEvent;
 class Target;
@@ -146,6 +147,7 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch*> _discovered;
+	ResearchTracker *_researchTracker;
 	std::map<std::string, int> _generatedEvents;
 	std::map<std::string, int> _ufopediaRuleStatus;
 	std::map<std::string, int> _manufactureRuleStatus;
@@ -174,7 +176,7 @@ private:
 	bool _alienContainmentChecked;
 	ScriptValues<SavedGame> _scriptValues;
 
-	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	static SaveInfo getSaveInfo(const std::string &file, const YAML::Node &doc, time_t timestamp, Language *lang);
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -320,7 +322,7 @@ public:
 	/// Gets if a certain list of research topics has been completed.
 	bool isResearched(const std::vector<const RuleResearch *> &research, bool considerDebugMode = true, bool skipDisabled = false) const;
 	/// Gets if a certain item has been obtained.
-	bool isItemObtained(const std::string &itemType) const;
+	bool isItemObtained(const std::string &itemType, const Mod *mod) const;
 	/// Gets if a certain facility has been built.
 	bool isFacilityBuilt(const std::string &facilityType) const;
 	/// Gets the soldier matching this ID.
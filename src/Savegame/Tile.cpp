@@ -218,6 +218,7 @@ void Tile::saveBinary(Uint8** buffer) const
 void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart part)
 {
 	_objects[part] = dat;
+	_cache.terrainChanged = 1;
 	_mapData->ID[part] = mapDataID;
 	_mapData->SetID[part] = mapDataSetID;
 	_objectsCache[part].isDoor = dat ? dat->isDoor() : 0;
@@ -377,6 +378,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 		if (unit && cost.Time && !cost.haveTU())
 			return 4;
 		_objectsCache[part].currentFrame = 1; // start opening door
+		_cache.terrainChanged = 1;
 		updateSprite((TilePart)part);
 		return 1;
 	}
@@ -396,6 +398,7 @@ int Tile::closeUfoDoor()
 		if (isUfoDoorOpen((TilePart)part))
 		{
 			_objectsCache[part].currentFrame = 0;
+			_cache.terrainChanged = 1;
 			retval = 1;
 			updateSprite((TilePart)part);
 		}
@@ -104,6 +104,7 @@ public:
 		Uint8 isNoFloor:1;
 		Uint8 bigWall:1;
 		Uint8 danger:1;
+		Uint8 terrainChanged:1;
 	};
 
 protected:
@@ -202,6 +203,24 @@ public:
 		return _cache.terrainLevel;
 	}
 
+	/**
+	 * Whether the shape of the terrain changed (a part was replaced or a ufo door opened or closed)
+	 * since the flag was cleared last time.
+	 * @return bool
+	 */
+	bool isTerrainChanged() const
+	{
+		return _cache.terrainChanged;
+	}
+
+	/**
+	 * Clears the terrain changed flag, after caches depending on the terrain shape were updated.
+	 */
+	void clearTerrainChanged()
+	{
+		_cache.terrainChanged = 0;
+	}
+
 	/**
 	 * Gets the tile's position.
 	 * @return position
@@ -32,7 +32,7 @@ namespace OpenXcom
  * Initializes a transfer.
  * @param hours Hours in-transit.
  */
-Transfer::Transfer(int hours) : _hours(hours), _soldier(0), _craft(0), _itemQty(0), _scientists(0), _engineers(0), _delivered(false)
+Transfer::Transfer(int hours) : _hours(hours), _soldier(0), _craft(0), _itemRule(0), _itemQty(0), _scientists(0), _engineers(0), _delivered(false)
 {
 }
 
@@ -92,10 +92,11 @@ bool Transfer::load(const YAML::Node& node, Base *base, const Mod *mod, SavedGam
 	}
 	if (const YAML::Node &item = node["itemId"])
 	{
-		_itemId = item.as<std::string>(_itemId);
-		if (mod->getItem(_itemId) == 0)
+		std::string type = item.as<std::string>();
+		_itemRule = mod->getItem(type);
+		if (_itemRule == 0)
 		{
-			Log(LOG_ERROR) << "Failed to load item " << _itemId;
+			Log(LOG_ERROR) << "Failed to load item " << type;
 			delete this;
 			return false;
 		}
@@ -125,7 +126,7 @@ YAML::Node Transfer::save(const Base *b, const Mod *mod) const
 	}
 	else if (_itemQty != 0)
 	{
-		node["itemId"] = _itemId;
+		node["itemId"] = _itemRule->getType();
 		node["itemQty"] = _itemQty;
 	}
 	else if (_scientists != 0)
@@ -172,21 +173,21 @@ Craft *Transfer::getCraft()
 
 /**
  * Returns the items being transferred.
- * @return Item ID.
+ * @return Item rule.
  */
-std::string Transfer::getItems() const
+const RuleItem *Transfer::getItems() const
 {
-	return _itemId;
+	return _itemRule;
 }
 
 /**
  * Changes the items being transferred.
- * @param id Item identifier.
+ * @param item Item rule.
  * @param qty Item quantity.
  */
-void Transfer::setItems(const std::string &id, int qty)
+void Transfer::setItems(const RuleItem *item, int qty)
 {
-	_itemId = id;
+	_itemRule = item;
 	_itemQty = qty;
 }
 
@@ -231,7 +232,11 @@ std::string Transfer::getName(Language *lang) const
 	{
 		return lang->getString("STR_ENGINEERS");
 	}
-	return lang->getString(_itemId);
+	else if (_itemRule != 0)
+	{
+		return lang->getString(_itemRule->getType());
+	}
+	return "";
 }
 
 /**
@@ -312,7 +317,7 @@ void Transfer::advance(Base *base)
 		}
 		else if (_itemQty != 0)
 		{
-			base->getStorageItems()->addItem(_itemId, _itemQty);
+			base->getStorageItems()->addItem(_itemRule, _itemQty);
 		}
 		else if (_scientists != 0)
 		{
@@ -41,6 +41,7 @@ class Language;
 class Base;
 class Mod;
 class SavedGame;
+class RuleItem;
 
 /**
  * Represents an item transfer.
@@ -53,7 +54,7 @@ private:
 	int _hours;
 	Soldier *_soldier;
 	Craft *_craft;
-	std::string _itemId;
+	const RuleItem *_itemRule;
 	int _itemQty, _scientists, _engineers;
 	bool _delivered;
 public:
@@ -72,9 +73,9 @@ public:
 	/// Gets the craft of the transfer.
 	Craft *getCraft();
 	/// Gets the items of the transfer.
-	std::string getItems() const;
+	const RuleItem *getItems() const;
 	/// Sets the items of the transfer.
-	void setItems(const std::string &id, int qty = 1);
+	void setItems(const RuleItem *item, int qty = 1);
 	/// Sets the scientists of the transfer.
 	void setScientists(int scientists);
 	/// Sets the engineers of the transfer.
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <string>
+#include <SDL.h>
+#include "version.h"
+#include "Engine/Exception.h"
+#include "Engine/Logger.h"
+#include "Engine/CrossPlatform.h"
+#include "Engine/Game.h"
+#include "Engine/Options.h"
+#include "Engine/FileMap.h"
+#include "Engine/State.h"
+#include "Engine/Script.h"
+#include "Savegame/BinarySave.h"
+#include "Battlescape/BattleBenchmark.h"
+#include "Geoscape/GeoscapeBenchmark.h"
+
+/**
+ * Headless benchmark runner.
+ *
+ * Usage: openxcom-benchmark battle [-deployment TYPE] [-terrain TYPE] [-race RACE]
+ *            [-craft TYPE] [-seed N] [-turns N] [-difficulty N] [-alienTech N]
+ *            [-shade N] [-depth N]
+ *        openxcom-benchmark geoscape [-load FILE] [-seed N] [-months N] [-difficulty N]
+ *            [-fastForward 0|1]
+ *        openxcom-benchmark globe [-step DEGREES]
+ *        openxcom-benchmark convert FILE [-binary 0|1]
+ *
+ * The convert mode rewrites a save in the binary (default) or text format, in place.
+ * Like the geoscape save, FILE is relative to the user folder.
+ * All modes also take [-scripts switch|goto] [-scriptCheck 0|1] to choose the loop running
+ * the mod's scripts, or to run them with both loops and report any difference.
+ * Comparing "Units hash" of battles with the same seed and different loops checks
+ * the scripts that change units too.
+ *
+ * The geoscape save file is relative to the user folder, without it a new game is started.
+ * The mod set is taken from the options of the user/config folder,
+ * so the usual -user, -cfg and -master arguments apply too.
+ */
+
+using namespace OpenXcom;
+
+namespace
+{
+
+void usage()
+{
+	std::cout << "OpenXcom benchmark v" << OPENXCOM_VERSION_SHORT << std::endl;
+	std::cout << "Usage: openxcom-benchmark battle [-deployment TYPE] [-terrain TYPE] [-race RACE] [-craft TYPE]" << std::endl;
+	std::cout << "           [-seed N] [-turns N] [-difficulty N] [-alienTech N] [-shade N] [-depth N]" << std::endl;
+	std::cout << "       openxcom-benchmark geoscape [-load FILE] [-seed N] [-months N] [-difficulty N] [-fastForward 0|1]" << std::endl;
+	std::cout << "       openxcom-benchmark globe [-step DEGREES]" << std::endl;
+	std::cout << "       openxcom-benchmark convert FILE [-binary 0|1]" << std::endl;
+	std::cout << "Any mode: [-scripts switch|goto] [-scriptCheck 0|1]" << std::endl;
+}
+
+/**
+ * Collects "-name value" pairs from the command line.
+ * @param args Command line arguments.
+ * @return Map of lowercase names to values.
+ */
+std::map<std::string, std::string> parseArgs(const std::vector<std::string> &args)
+{
+	std::map<std::string, std::string> result;
+	for (size_t i = 2; i + 1 < args.size(); ++i)
+	{
+		const std::string &arg = args[i];
+		if (arg.size() > 1 && arg[0] == '-')
+		{
+			std::string name = arg.substr(arg[1] == '-' ? 2 : 1);
+			std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+			result[name] = args[++i];
+		}
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	CrossPlatform::processArgs(argc, argv);
+	const std::vector<std::string> &args = CrossPlatform::getArgs();
+	if (args.size() < 2 || (args[1] != "battle" && args[1] != "geoscape" && args[1] != "globe" && args[1] != "convert") ||
+		(args[1] == "convert" && (args.size() < 3 || args[2][0] == '-')))
+	{
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	// no window and no sound, everything else runs as in the game
+	SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+	SDL_putenv(const_cast<char*>("SDL_AUDIODRIVER=dummy"));
+
+	if (!Options::init())
+		return EXIT_SUCCESS;
+	Options::baseXResolution = Options::displayWidth;
+	Options::baseYResolution = Options::displayHeight;
+	Options::battleAutoEnd = false;
+
+	if (args[1] == "convert")
+	{
+		// no mods needed, the save is converted node by node
+		std::map<std::string, std::string> options = parseArgs(args);
+		try
+		{
+			BinarySave::convert(Options::getMasterUserFolder() + args[2], !options.count("binary") || options["binary"] != "0");
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	int result = EXIT_FAILURE;
+	Game *game = new Game("OpenXcom benchmark");
+	State::setGamePtr(game);
+	try
+	{
+		// the loop running scripts is chosen when the mods are parsed
+		std::map<std::string, std::string> options = parseArgs(args);
+		if (options.count("scripts"))
+		{
+			Options::oxceScriptComputedGoto = options["scripts"] == "goto";
+		}
+		if (options.count("scriptcheck"))
+		{
+			Options::oxceScriptCheckDispatch = options["scriptcheck"] != "0";
+		}
+
+		Options::updateMods();
+		game->loadMods();
+		game->loadLanguages();
+
+		if (args[1] == "battle")
+		{
+			BattleBenchmark benchmark(game, parseArgs(args));
+			benchmark.generate();
+			result = benchmark.run(std::cout);
+		}
+		else if (args[1] == "globe")
+		{
+			result = GeoscapeBenchmark::checkGlobe(game, parseArgs(args), std::cout);
+		}
+		else
+		{
+			GeoscapeBenchmark benchmark(game, parseArgs(args));
+			benchmark.generate();
+			result = benchmark.run(std::cout);
+		}
+	}
+	catch (std::exception &e)
+	{
+		Log(LOG_ERROR) << e.what();
+		std::cerr << e.what() << std::endl;
+	}
+
+	if (Options::oxceScriptCheckDispatch)
+	{
+		int errors = ScriptWorkerBase::getCheckDispatchErrors();
+		std::cout << "Script loop differences: " << errors << std::endl;
+		if (errors > 0)
+		{
+			result = EXIT_FAILURE;
+		}
+	}
+
+	delete game;
+	FileMap::clear(true, false);
+	return result;
+}
+
+namespace OpenXcom
+{
+	Exception::Exception(const std::string &msg) : runtime_error(msg) { }
+}